@@ -0,0 +1,177 @@
+/*! @file DateTimeBenchmark.ino
+
+ @section DateTimeBenchmark_intro_section Description
+
+Example program which measures the speed of the DateTime conversions between year/month/day and
+UNIX time. The library's loop-free conversions are compared against a copy of the original
+loop-based implementation, which is kept in this program as the reference. First every day from
+2000-01-01 to 2099-12-31, at a varying time of day, is converted with the DateTime(uint32_t)
+constructor and the reference and all fields are checked to be identical. Then every 7th day is
+converted in both directions with both implementations and the time taken by each is displayed
+together with the speedup.\n\n No MCP7940 needs to be connected, the program only uses the
+DateTime class. It runs on any Arduino and can also be compiled and run on a PC with the host
+simulator in the library's "extras/simulator" directory, in which case the PC's clock is used for
+the timing.\n\n The library as well as the most current version of this program is available on
+GitHub at https://github.com/Zanduino/MCP7940
+
+@section DateTimeBenchmark_license GNU General Public License v3.0
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section DateTimeBenchmark_Versions Changelog
+
+Version| Date       | Developer           | Comments
+------ | ---------- | ------------------- | --------
+1.0.0  | 2026-10-16 | agent               | Initial coding
+*/
+#include "MCP7940.h"  // Include the MCP7940 RTC library
+#if defined(ARDUINO)
+  #define benchMicros micros  ///< Use the Arduino's own clock
+#else
+  #include <chrono>  // The host simulator only has a virtual clock, so use the PC's
+static uint32_t benchMicros() {
+  /*!
+      @brief  Return the PC's steady clock in microseconds
+  */
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}  // of function benchMicros()
+#endif
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint16_t DAY_STEP{7};           ///< Convert every n-th day
+const uint16_t DAYS_2000_TO_2100{36525};                                           ///< Days tested
+const uint8_t  refDaysInMonth[] PROGMEM = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};  ///< ref
+/***************************************************************************************************
+** Declare global variables                                                                       **
+***************************************************************************************************/
+volatile uint32_t sink{0};  ///< Keeps the compiler from optimizing the loops away
+
+uint32_t refUnixtime(uint16_t y, const uint8_t m, const uint8_t d) {
+  /*!
+      @brief     Original loop-based conversion of a date at midnight to UNIX time
+      @param[in] y Year 2000-2099
+      @param[in] m Month
+      @param[in] d Day
+      @return    UNIX time
+  */
+  y -= 2000;
+  uint16_t days = d;
+  for (uint8_t i = 1; i < m; ++i) days += pgm_read_byte(refDaysInMonth + i - 1);
+  if (m > 2 && y % 4 == 0) ++days;
+  days += 365 * y + (y + 3) / 4 - 1;
+  return days * 86400UL + SECS_1970_TO_2000;
+}  // of function refUnixtime()
+void refDate(uint32_t t, uint16_t& y, uint8_t& m, uint8_t& d) {
+  /*!
+      @brief      Original loop-based conversion of UNIX time to a date
+      @param[in]  t UNIX time
+      @param[out] y Year
+      @param[out] m Month
+      @param[out] d Day
+  */
+  uint16_t days = (t - SECS_1970_TO_2000) / 86400UL;
+  uint8_t  leap;
+  for (y = 0;; ++y) {
+    leap = y % 4 == 0;
+    if (days < (uint16_t)365 + leap) break;
+    days -= 365 + leap;
+  }  // of for-next each year
+  for (m = 1;; ++m) {
+    uint8_t daysPerMonth = pgm_read_byte(refDaysInMonth + m - 1);
+    if (leap && m == 2) ++daysPerMonth;
+    if (days < daysPerMonth) break;
+    days -= daysPerMonth;
+  }  // of for-next each month
+  y += 2000;
+  d = days + 1;
+}  // of function refDate()
+void showResult(const __FlashStringHelper* name, const uint32_t reference, const uint32_t library) {
+  /*!
+      @brief     Display the timing of one conversion
+      @param[in] name      Name of the conversion
+      @param[in] reference Microseconds used by the original implementation
+      @param[in] library   Microseconds used by the library
+  */
+  Serial.print(name);
+  Serial.print(F(": original "));
+  Serial.print(reference);
+  Serial.print(F("us, library "));
+  Serial.print(library);
+  Serial.print(F("us, speedup "));
+  Serial.print(library ? (float)reference / library : 0.0);
+  Serial.println(F("x"));
+}  // of function showResult()
+
+void setup() {
+  /*!
+      @brief  Arduino method called once upon start or restart.
+  */
+  Serial.begin(SERIAL_SPEED);
+#ifdef __AVR_ATmega32U4__  // If on a 32U4 processor, wait 3s for serial interface to initialize
+  delay(3000);
+#endif
+  Serial.print(F("\nStarting DateTimeBenchmark program\n"));
+  Serial.print(F("- Compiled with c++ version "));
+  Serial.print(F(__VERSION__));
+  Serial.print(F("\n"));
+  uint32_t errors{0};
+  for (uint16_t day = 0; day < DAYS_2000_TO_2100; ++day) {  // Check results first
+    uint32_t t = SECS_1970_TO_2000 + day * 86400UL + day * 7919UL % 86400UL;
+    uint16_t y;
+    uint8_t  m, d;
+    refDate(t, y, m, d);
+    DateTime dt(t);
+    if (dt.year() != y || dt.month() != m || dt.day() != d || dt.hour() != t / 3600 % 24 ||
+        dt.minute() != t / 60 % 60 || dt.second() != t % 60 || dt.unixtime() != t ||
+        refUnixtime(y, m, d) != t - t % 86400UL) {
+      ++errors;
+    }  // of if-then results differ
+  }    // of for-next each day
+  Serial.print(F("- Mismatches between original and library: "));
+  Serial.println(errors);
+  uint32_t start, reference, library;
+  start = benchMicros();
+  for (uint16_t day = 0; day < DAYS_2000_TO_2100; day += DAY_STEP) {  // Original date to UNIX
+    uint16_t y;
+    uint8_t  m, d;
+    refDate(SECS_1970_TO_2000 + day * 86400UL, y, m, d);
+    sink = sink + refUnixtime(y, m, d);
+  }  // of for-next each day
+  reference = benchMicros() - start;
+  start     = benchMicros();
+  for (uint16_t day = 0; day < DAYS_2000_TO_2100; day += DAY_STEP) {  // Library date to UNIX
+    DateTime dt(SECS_1970_TO_2000 + day * 86400UL);
+    sink = sink + DateTime(dt.year(), dt.month(), dt.day()).unixtime();
+  }  // of for-next each day
+  library = benchMicros() - start;
+  showResult(F("UNIX time to Y/M/D to UNIX time"), reference, library);
+  start = benchMicros();
+  for (uint16_t day = 0; day < DAYS_2000_TO_2100; day += DAY_STEP) {  // Original day-of-week
+    uint16_t y;
+    uint8_t  m, d;
+    refDate(SECS_1970_TO_2000 + day * 86400UL, y, m, d);
+    sink = sink + ((refUnixtime(y, m, d) - SECS_1970_TO_2000) / 86400UL + 6) % 7;
+  }  // of for-next each day
+  reference = benchMicros() - start;
+  start     = benchMicros();
+  for (uint16_t day = 0; day < DAYS_2000_TO_2100; day += DAY_STEP) {  // Library day-of-week
+    sink = sink + DateTime(SECS_1970_TO_2000 + day * 86400UL).dayOfTheWeek();
+  }  // of for-next each day
+  library = benchMicros() - start;
+  showResult(F("UNIX time to day-of-week"), reference, library);
+}  // of method setup()
+
+void loop() {
+  /*!
+      @brief  Arduino method called after setup() which loops forever, nothing to do here
+  */
+}  // of method loop()
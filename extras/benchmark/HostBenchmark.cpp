@@ -0,0 +1,410 @@
+/*! @file HostBenchmark.cpp
+ @section HostBenchmark_intro_section Description
+
+Host-side benchmark of the MCP7940 library, built with a normal Linux compiler against the host
+simulator in "extras/simulator". It has three parts:\n
+- CPU time of the DateTime and TimeSpan conversions and of the BCD register helpers, measured with
+  the PC's steady clock over large randomized inputs. Each benchmark is run several times and the
+  fastest run is reported in nanoseconds per operation together with a checksum of the results, so
+  that a faster but wrong implementation shows up as a changed checksum. The original per-field
+  division-based code of encodeTime() and decodeTime() is timed as well, as the baseline\n
+- Check of the integer calibration trim against the exact and the floating point results. The
+  BCD register conversions are checked exhaustively by "extras/tests/SimulatorTests.cpp"\n
+- I2C cost of each public MCP7940_Class method, measured on the simulated Wire bus as the number
+  of transactions, bytes and bus time of a single call, with the register cache off and on\n\n
+All results are written to stdout as JSON lines, one object per measurement with a "bench" field
+of "meta", "check", "cpu" or "bus". The "bus" lines are deterministic and can be compared between
+commits with diff, the "cpu" lines are compared by their "ns_per_op" values. The exit code is 1 if
+a check found a mismatch.\n\n
+Usage: "HostBenchmark [count] [seed]", where "count" is the number of random inputs per CPU
+benchmark (default 1048576) and "seed" the random seed (default 1)
+*/
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "MCP7940.h"
+#include "MCP7940_Simulator.h"
+
+const uint8_t RUNS{5};  ///< Runs per CPU benchmark, the fastest is reported
+
+uint8_t refBcd2int(const uint8_t bcd) {
+  /*!
+   @brief     Scalar reference of bcd2int(), the original division-based conversion
+   @param[in] bcd BCD value
+   @return    Integer value
+  */
+  return bcd / 16 * 10 + bcd % 16;
+}  // of function refBcd2int()
+uint8_t refInt2bcd(const uint8_t dec) {
+  /*!
+   @brief     Scalar reference of int2bcd(), the original division-based conversion
+   @param[in] dec Integer value
+   @return    BCD value
+  */
+  return dec / 10 * 16 + dec % 10;
+}  // of function refInt2bcd()
+
+MCP7940_Simulator     simulatedRTC;  ///< The simulated device on the first bus
+std::vector<uint32_t> times;         ///< Random UNIX times from 2000 to 2099
+std::vector<uint8_t>  values;        ///< Random integers 0-99
+std::vector<uint8_t>  bcds;          ///< BCD form of "values"
+std::vector<uint8_t>  blocks;        ///< RTCSEC to RTCYEAR register blocks of "times"
+std::vector<DateTime> dates;         ///< DateTime form of "times", rewritten by decodeTimes()
+
+template <typename F>
+void cpu(const char* name, const size_t count, F body) {
+  /*!
+   @brief     Time a CPU benchmark and write its result line
+   @param[in] name  Benchmark name
+   @param[in] count Operations per run
+   @param[in] body  Function running all operations once and returning a checksum
+  */
+  double   best{1e30};
+  uint32_t checksum{0};
+  for (uint8_t run = 0; run < RUNS; ++run) {
+    const auto start = std::chrono::steady_clock::now();
+    checksum         = body();
+    const double ns  = std::chrono::duration<double, std::nano>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    if (ns < best) best = ns;
+  }  // of for-next each run
+  printf("{\"bench\":\"cpu\",\"name\":\"%s\",\"count\":%zu,\"ns_per_op\":%.3f,\"checksum\":%u}\n",
+         name, count, best / count, checksum);
+}  // of function cpu()
+
+template <typename F>
+void bus(const char* name, const bool cache, F call) {
+  /*!
+   @brief     Measure the I2C traffic of one library call and write its result line
+   @details   The device and the library instance are set up the same way for every call: the
+              clock set and running, alarm 0 set and the battery enabled
+   @param[in] name  Method name, with the arguments where there are several variants
+   @param[in] cache State of the register cache during the call
+   @param[in] call  Function making the call on the instance passed to it
+  */
+  simulatedRTC.reset();
+  MCP7940_Class rtc;
+  rtc.begin();
+  rtc.adjust(DateTime(2026, 10, 16, 12, 0, 0));
+  rtc.setAlarm(0, 7, DateTime(2026, 10, 16, 12, 0, 30));
+  rtc.setBattery(true);
+  rtc.setCache(cache);
+  if (cache) rtc.refreshCache();
+  Wire.resetStatistics();
+  call(rtc);
+  const SimBusStatistics& stats = Wire.statistics();
+  printf(
+      "{\"bench\":\"bus\",\"api\":\"%s\",\"cache\":%s,\"transactions\":%u,\"writes\":%u,"
+      "\"reads\":%u,\"bytes\":%u,\"us_100k\":%llu,\"us_400k\":%llu}\n",
+      name, cache ? "true" : "false", stats.transactions, stats.writes, stats.reads, stats.bytes,
+      (unsigned long long)stats.microsAt(100000), (unsigned long long)stats.microsAt(400000));
+}  // of function bus()
+
+void check(const char* name, const uint32_t cases, const uint32_t mismatches) {
+  /*!
+   @brief     Write the result line of an equivalence check
+   @param[in] name       Checked function
+   @param[in] cases      Number of inputs compared
+   @param[in] mismatches Number of inputs with a result different from the reference
+  */
+  printf("{\"bench\":\"check\",\"name\":\"%s\",\"cases\":%u,\"mismatches\":%u}\n", name,
+         cases, mismatches);
+}  // of function check()
+
+struct Measurement {
+  /*!
+   @struct  Measurement
+   @brief   One square wave frequency measurement used by the calibration benchmarks
+  */
+  int8_t   trim;        ///< Trim before the calibration
+  uint8_t  speed;       ///< Square wave frequency index 0-4
+  uint32_t counts;      ///< Counted cycles
+  uint32_t gateMicros;  ///< Gate time
+  float    fMeas;       ///< counts/gate in Herz, rounded to float
+};
+std::vector<Measurement> measurements;  ///< Random measurements of all square wave frequencies
+
+Measurement measurement(std::mt19937& random) {
+  /*!
+   @brief     Return a random frequency measurement within 300ppm of the ideal frequency
+   @details   The 1Hz and 64Hz outputs are measured as the period of 1 to 100 cycles, the
+              kHz outputs as the cycles counted in a gate time of 0.1 to 10 seconds
+   @param[in] random Random generator
+   @return    Measurement
+  */
+  const uint32_t ideal[5] = {1, 4096, 8192, 32768, 64};
+  Measurement    m;
+  m.trim         = (int8_t)std::uniform_int_distribution<int16_t>(-127, 127)(random);
+  m.speed        = std::uniform_int_distribution<uint16_t>(0, 4)(random);
+  std::uniform_real_distribution<double> ppm(-300.0, 300.0);
+  const double                           f = ideal[m.speed] * (1.0 + ppm(random) / 1e6);
+  if (ideal[m.speed] < 4096) {
+    m.counts     = std::uniform_int_distribution<uint32_t>(1, 100)(random);
+    m.gateMicros = (uint32_t)(m.counts * 1e6 / f + 0.5);
+  } else {
+    m.gateMicros = std::uniform_int_distribution<uint32_t>(100000, 10000000)(random);
+    m.counts     = (uint32_t)(f * m.gateMicros / 1e6 + 0.5);
+  }  // of if-then-else period or frequency measurement
+  m.fMeas = (float)(m.counts * 1e6 / m.gateMicros);
+  return m;
+}  // of function measurement()
+
+uint32_t checkCalibration(const uint32_t seed) {
+  /*!
+   @brief     Compare the integer calibration trim with the exact result and the float version
+   @details   The integer version has to give the exactly truncated trim of the datasheet formula,
+              computed here with long double. The float version rounds fMeas to 24 bits, so it may
+              differ by 1 from the integer version, any larger difference is a mismatch
+   @param[in] seed Random seed
+   @return    Total number of mismatches
+  */
+  const uint32_t ideal[5] = {1, 4096, 8192, 32768, 64};
+  std::mt19937   random(seed);
+  uint32_t       exact{0}, rounding{0};
+  const uint32_t cases{1000000};
+  for (uint32_t i = 0; i < cases; ++i) {
+    const Measurement m = measurement(random);
+    const int8_t      trim =
+        MCP7940_Codec::calibrationTrim(m.trim, m.speed, m.counts, m.gateMicros);
+    const long double fi = ideal[m.speed];
+    long double       ref =
+        (m.speed == 3 ? 0 : m.trim) +
+        ((long double)m.counts * 1000000 - m.gateMicros * fi) * 983040 / (m.gateMicros * fi);
+    ref = ref > 127 ? 127 : ref < -127 ? -127 : ref;
+    if (trim != (int8_t)ref) ++exact;
+    const int8_t trimFloat = MCP7940_Codec::calibrationTrim(m.trim, m.speed, m.fMeas);
+    if (trimFloat - trim > 1 || trim - trimFloat > 1) ++rounding;
+  }  // of for-next each case
+  check("calibrationTrim(counts)", cases, exact);
+  check("calibrationTrim(float)", cases, rounding);
+  return exact + rounding;
+}  // of function checkCalibration()
+
+void cpuBenchmarks(const size_t count, const uint32_t seed) {
+  /*!
+   @brief     Run all CPU benchmarks
+   @param[in] count Number of random inputs
+   @param[in] seed  Random seed
+  */
+  std::mt19937                            random(seed);
+  std::uniform_int_distribution<uint32_t> time(SECS_1970_TO_2000,
+                                               SECS_1970_TO_2000 + 36525UL * 86400UL - 1);
+  std::uniform_int_distribution<uint32_t> value(0, 99);
+  times.resize(count);
+  values.resize(count);
+  bcds.resize(count);
+  blocks.resize(count * 7);
+  dates.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    times[i]  = time(random);
+    values[i] = value(random);
+    bcds[i]   = values[i] / 10 << 4 | values[i] % 10;
+    dates[i] = DateTime(times[i]);
+    MCP7940_Codec::encodeTime(dates[i], dates[i].dayOfTheWeek(), &blocks[i * 7]);
+  }  // of for-next each input
+  measurements.resize(count);
+  for (size_t i = 0; i < count; ++i) measurements[i] = measurement(random);
+  cpu("DateTime(uint32_t)", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      const DateTime dt(times[i]);
+      sum += dt.year() + dt.month() + dt.day() + dt.hour() + dt.minute() + dt.second();
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("DateTime(y,m,d,h,m,s).unixtime", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      const DateTime& in = dates[i];
+      sum += DateTime(in.year(), in.month(), in.day(), in.hour(), in.minute(), in.second())
+                 .unixtime();
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("DateTime::dayOfTheWeek", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) sum += dates[i].dayOfTheWeek() * (uint32_t)i;
+    return sum;
+  });
+  cpu("DateTime::secondstime", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) sum += dates[i].secondstime();
+    return sum;
+  });
+  cpu("DateTime+TimeSpan", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      sum += (dates[i] + TimeSpan((int32_t)(times[count - 1 - i] % 864000))).unixtime();
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("DateTime-DateTime", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      const TimeSpan span = dates[i] - dates[i * 7919 % count];
+      sum += span.days() + span.hours() + span.minutes() + span.seconds();
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("bcd2int", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) sum += MCP7940_Codec::bcd2int(bcds[i]) * (uint32_t)i;
+    return sum;
+  });
+  cpu("int2bcd", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) sum += MCP7940_Codec::int2bcd(values[i]) * (uint32_t)i;
+    return sum;
+  });
+  cpu("encodeTime", count, [count]() {
+    uint32_t sum{0};
+    uint8_t  block[7];
+    for (size_t i = 0; i < count; ++i) {
+      MCP7940_Codec::encodeTime(dates[i], dates[i].dayOfTheWeek(), block);
+      for (uint8_t j = 0; j < 7; ++j) sum += block[j] << j;
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("encodeTime(scalar)", count, [count]() {
+    uint32_t sum{0};
+    uint8_t  block[7];
+    for (size_t i = 0; i < count; ++i) {
+      const DateTime& dt = dates[i];
+      block[0]           = refInt2bcd(dt.second()) | 0x80;
+      block[1]           = refInt2bcd(dt.minute());
+      block[2]           = refInt2bcd(dt.hour());
+      block[3]           = dt.dayOfTheWeek();
+      block[4]           = refInt2bcd(dt.day());
+      block[5]           = refInt2bcd(dt.month());
+      block[6]           = refInt2bcd(dt.year() - 2000);
+      for (uint8_t j = 0; j < 7; ++j) sum += block[j] << j;
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("decodeTime", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      sum += MCP7940_Codec::decodeTime(&blocks[i * 7]).unixtime();
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("decodeTime(scalar)", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      const uint8_t* block = &blocks[i * 7];
+      sum += DateTime(refBcd2int(block[6]) + 2000, refBcd2int(block[5] & 0x1F),
+                      refBcd2int(block[4] & 0x3F), refBcd2int(block[2] & 0x3F),
+                      refBcd2int(block[1] & 0x7F), refBcd2int(block[0] & 0x7F))
+                 .unixtime();
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("decodeTimes", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; i += 65535) {
+      const uint16_t n = count - i < 65535 ? count - i : 65535;
+      MCP7940_Class::decodeTimes(&blocks[i * 7], &dates[i], n);
+    }  // of for-next each batch
+    for (size_t i = 0; i < count; ++i) sum += dates[i].unixtime();
+    return sum;
+  });
+  cpu("calibrationTrim(float)", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      const Measurement& m = measurements[i];
+      sum += (uint8_t)MCP7940_Codec::calibrationTrim(m.trim, m.speed, m.fMeas) * (uint32_t)i;
+    }  // of for-next each input
+    return sum;
+  });
+  cpu("calibrationTrim(counts)", count, [count]() {
+    uint32_t sum{0};
+    for (size_t i = 0; i < count; ++i) {
+      const Measurement& m = measurements[i];
+      sum += (uint8_t)MCP7940_Codec::calibrationTrim(m.trim, m.speed, m.counts, m.gateMicros) *
+             (uint32_t)i;
+    }  // of for-next each input
+    return sum;
+  });
+}  // of function cpuBenchmarks()
+
+void busBenchmarks() {
+  /*!
+   @brief     Measure the I2C traffic of each public method, with the register cache off and on
+  */
+  for (uint8_t c = 0; c < 2; ++c) {
+    const bool cache = c == 1;
+    bus("begin", cache, [](MCP7940_Class& rtc) { rtc.begin(); });
+    bus("deviceStatus", cache, [](MCP7940_Class& rtc) { rtc.deviceStatus(); });
+    bus("deviceStart", cache, [](MCP7940_Class& rtc) { rtc.deviceStart(); });
+    bus("deviceStop", cache, [](MCP7940_Class& rtc) { rtc.deviceStop(); });
+    bus("now", cache, [](MCP7940_Class& rtc) { rtc.now(); });
+    bus("adjust(dt)", cache,
+        [](MCP7940_Class& rtc) { rtc.adjust(DateTime(2027, 1, 2, 3, 4, 5)); });
+    bus("adjust(dt,burst)", cache,
+        [](MCP7940_Class& rtc) { rtc.adjust(DateTime(2027, 1, 2, 3, 4, 5), true); });
+    bus("calibrate()", cache, [](MCP7940_Class& rtc) { rtc.calibrate(); });
+    bus("calibrate(int8_t)", cache, [](MCP7940_Class& rtc) { rtc.calibrate((int8_t)-23); });
+    bus("getCalibrationTrim", cache, [](MCP7940_Class& rtc) { rtc.getCalibrationTrim(); });
+    bus("weekdayRead", cache, [](MCP7940_Class& rtc) { rtc.weekdayRead(); });
+    bus("weekdayWrite", cache, [](MCP7940_Class& rtc) { rtc.weekdayWrite(3); });
+    bus("setMFP", cache, [](MCP7940_Class& rtc) { rtc.setMFP(true); });
+    bus("getMFP", cache, [](MCP7940_Class& rtc) { rtc.getMFP(); });
+    bus("setAlarm", cache,
+        [](MCP7940_Class& rtc) { rtc.setAlarm(1, 7, DateTime(2026, 10, 17, 1, 2, 3)); });
+    bus("setAlarmPolarity", cache, [](MCP7940_Class& rtc) { rtc.setAlarmPolarity(true); });
+    bus("getAlarm", cache, [](MCP7940_Class& rtc) {
+      uint8_t type;
+      rtc.getAlarm(0, type);
+    });
+    bus("getAlarms", cache, [](MCP7940_Class& rtc) {
+      MCP7940_Alarm alarms[2];
+      rtc.getAlarms(alarms);
+    });
+    bus("clearAlarm", cache, [](MCP7940_Class& rtc) { rtc.clearAlarm(0); });
+    bus("setAlarmState", cache, [](MCP7940_Class& rtc) { rtc.setAlarmState(0, false); });
+    bus("getAlarmState", cache, [](MCP7940_Class& rtc) { rtc.getAlarmState(0); });
+    bus("isAlarm", cache, [](MCP7940_Class& rtc) { rtc.isAlarm(0); });
+    bus("getSQWSpeed", cache, [](MCP7940_Class& rtc) { rtc.getSQWSpeed(); });
+    bus("setSQWSpeed", cache, [](MCP7940_Class& rtc) { rtc.setSQWSpeed(0); });
+    bus("setSQWState", cache, [](MCP7940_Class& rtc) { rtc.setSQWState(true); });
+    bus("getSQWState", cache, [](MCP7940_Class& rtc) { rtc.getSQWState(); });
+    bus("setBattery", cache, [](MCP7940_Class& rtc) { rtc.setBattery(false); });
+    bus("getBattery", cache, [](MCP7940_Class& rtc) { rtc.getBattery(); });
+    bus("getPowerFail", cache, [](MCP7940_Class& rtc) { rtc.getPowerFail(); });
+    bus("clearPowerFail", cache, [](MCP7940_Class& rtc) { rtc.clearPowerFail(); });
+    bus("getPowerDown", cache, [](MCP7940_Class& rtc) { rtc.getPowerDown(); });
+    bus("getPowerUp", cache, [](MCP7940_Class& rtc) { rtc.getPowerUp(); });
+    bus("getPowerFailTimes", cache, [](MCP7940_Class& rtc) {
+      DateTime down, up;
+      rtc.getPowerFailTimes(down, up);
+    });
+    bus("getPPMDeviation", cache,
+        [](MCP7940_Class& rtc) { rtc.getPPMDeviation(DateTime(2026, 10, 17, 12, 0, 0)); });
+    bus("readSnapshot", cache, [](MCP7940_Class& rtc) {
+      MCP7940_Snapshot snapshot;
+      rtc.readSnapshot(snapshot);
+    });
+    bus("readRAM(64)", cache, [](MCP7940_Class& rtc) {
+      uint8_t ram[MCP7940_RAM_SIZE];
+      rtc.readRAM(0, ram);
+    });
+    bus("writeRAM(64)", cache, [](MCP7940_Class& rtc) {
+      uint8_t ram[MCP7940_RAM_SIZE] = {0};
+      rtc.writeRAM(0, ram);
+    });
+  }  // of for-next cache off and on
+}  // of function busBenchmarks()
+
+int main(int argc, char** argv) {
+  const size_t   count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1048576;
+  const uint32_t seed  = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1;
+  Wire.attach(simulatedRTC);
+  printf("{\"bench\":\"meta\",\"compiler\":\"%s\",\"count\":%zu,\"seed\":%u,\"runs\":%u}\n",
+         __VERSION__, count, seed, RUNS);
+  const uint32_t mismatches = checkCalibration(seed);
+  if (count) cpuBenchmarks(count, seed);
+  busBenchmarks();
+  return mismatches ? 1 : 0;
+}  // of function main()
@@ -0,0 +1,161 @@
+/*! @file Arduino.cpp
+ @section Arduino_sim_cpp_intro_section Description
+
+Host-side implementation of the Arduino core functions declared in the simulator's "Arduino.h". See
+that header for details.
+*/
+#include "Arduino.h"
+
+HardwareSerial Serial;  ///< Standard Arduino Serial object
+
+/***************************************************************************************************
+** Simulated clock, pins and interrupts                                                          **
+***************************************************************************************************/
+static uint64_t          virtualMicros{0};        ///< Current virtual time in microseconds
+static const uint8_t     MAX_LISTENERS{8};        ///< Maximum number of clock listeners
+static SimClockListener* listeners[MAX_LISTENERS];///< Registered clock listeners
+static uint8_t           listenerCount{0};        ///< Number of registered listeners
+static bool              advancing{false};        ///< Guard against recursive clock advances
+static uint32_t          pendingMicros{0};        ///< Time requested while already advancing
+static int32_t           millisSkew{0};           ///< Error of the millis() clock in ppm
+static uint8_t           pinLevel[SIM_PIN_COUNT]; ///< Current level of each digital pin
+static void (*pinISR[SIM_PIN_COUNT])();           ///< Interrupt handler attached to each pin
+static uint8_t pinISRMode[SIM_PIN_COUNT];         ///< Edge mode for each attached handler
+
+SimClockListener::SimClockListener() {
+  /*!
+   @brief   Register the new listener with the virtual clock
+  */
+  if (listenerCount < MAX_LISTENERS) listeners[listenerCount++] = this;
+}  // of constructor SimClockListener()
+SimClockListener::~SimClockListener() {
+  /*!
+   @brief   Remove the listener from the virtual clock
+  */
+  for (uint8_t i = 0; i < listenerCount; ++i) {
+    if (listeners[i] == this) {
+      for (uint8_t j = i + 1; j < listenerCount; ++j) listeners[j - 1] = listeners[j];
+      --listenerCount;
+      break;
+    }  // of if-then found this listener
+  }    // of for-next each listener
+}  // of destructor ~SimClockListener()
+uint64_t simulatorMicros() {
+  /*!
+   @brief   Return the full 64-bit virtual time
+   @return  microseconds since the simulation started
+  */
+  return virtualMicros;
+}  // of function simulatorMicros()
+void simulatorAdvance(const uint32_t us) {
+  /*!
+   @brief     Advance the virtual clock and notify all listeners
+   @details   Listeners may cause further time to pass (an interrupt handler which performs I2C
+              traffic, for example). That time is queued and applied once the current advance has
+              been delivered so that every listener sees a strictly increasing clock
+   @param[in] us Number of microseconds to advance
+  */
+  if (advancing) {
+    pendingMicros += us;
+    return;
+  }  // of if-then nested call
+  advancing       = true;
+  uint32_t amount = us;
+  while (amount) {
+    virtualMicros += amount;
+    for (uint8_t i = 0; i < listenerCount; ++i) listeners[i]->elapse(amount);
+    amount        = pendingMicros;
+    pendingMicros = 0;
+  }  // of while time left to deliver
+  advancing = false;
+}  // of function simulatorAdvance()
+void simulatorSetMillisSkew(const int32_t ppm) {
+  /*!
+   @brief     Make millis() run fast or slow, like a ceramic resonator instead of a crystal
+   @details   Only millis() is affected, the virtual clock, micros() and the simulated devices keep
+              the true time
+   @param[in] ppm Error in parts per million, positive values make millis() run fast
+  */
+  millisSkew = ppm;
+}  // of function simulatorSetMillisSkew()
+uint32_t millis() {
+  const int64_t skewed = (int64_t)virtualMicros + (int64_t)virtualMicros * millisSkew / 1000000;
+  return (uint32_t)(skewed / 1000);
+}  // of function millis()
+uint32_t micros() {
+  simulatorAdvance(1);  // Reading the clock takes time, so busy-wait loops make progress
+  return (uint32_t)virtualMicros;
+}  // of function micros()
+void     delay(const uint32_t ms) { simulatorAdvance(ms * 1000UL); }
+void     delayMicroseconds(const uint32_t us) { simulatorAdvance(us); }
+void     pinMode(const uint8_t pin, const uint8_t mode) {
+  if (pin < SIM_PIN_COUNT && mode == INPUT_PULLUP) pinLevel[pin] = HIGH;
+}  // of function pinMode()
+void digitalWrite(const uint8_t pin, const uint8_t level) {
+  if (pin < SIM_PIN_COUNT) pinLevel[pin] = level ? HIGH : LOW;
+}  // of function digitalWrite()
+int digitalRead(const uint8_t pin) {
+  simulatorAdvance(1);  // Polling a pin takes time, so busy-wait loops make progress
+  return pin < SIM_PIN_COUNT ? pinLevel[pin] : LOW;
+}  // of function digitalRead()
+void attachInterrupt(const uint8_t interruptNumber, void (*isr)(), const uint8_t mode) {
+  if (interruptNumber < SIM_PIN_COUNT) {
+    pinISR[interruptNumber]     = isr;
+    pinISRMode[interruptNumber] = mode;
+  }  // of if-then valid pin
+}  // of function attachInterrupt()
+void detachInterrupt(const uint8_t interruptNumber) {
+  if (interruptNumber < SIM_PIN_COUNT) pinISR[interruptNumber] = nullptr;
+}  // of function detachInterrupt()
+void simulatorSetPin(const uint8_t pin, const uint8_t level) {
+  /*!
+   @brief     Drive a pin from a simulated device and fire any attached interrupt handler
+   @param[in] pin   Pin number
+   @param[in] level New level, LOW or HIGH
+  */
+  if (pin >= SIM_PIN_COUNT) return;
+  uint8_t previous = pinLevel[pin];
+  pinLevel[pin]    = level ? HIGH : LOW;
+  if (pinISR[pin] == nullptr || previous == pinLevel[pin]) return;
+  if (pinISRMode[pin] == CHANGE || (pinISRMode[pin] == RISING && pinLevel[pin] == HIGH) ||
+      (pinISRMode[pin] == FALLING && pinLevel[pin] == LOW)) {
+    pinISR[pin]();
+  }  // of if-then edge matches the interrupt mode
+}  // of function simulatorSetPin()
+
+/***************************************************************************************************
+** Print class, all output goes to stdout                                                        **
+***************************************************************************************************/
+size_t Print::write(const uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+size_t Print::write(const char* str) {
+  size_t n = 0;
+  while (*str) n += write((uint8_t)*str++);
+  return n;
+}  // of method write()
+size_t Print::print(const __FlashStringHelper* str) {
+  return write(reinterpret_cast<const char*>(str));
+}  // of method print()
+size_t Print::print(const char* str) { return write(str); }
+size_t Print::print(const char c) { return write((uint8_t)c); }
+size_t Print::print(const long n, const int base) {
+  if (n < 0 && base == 10) return write('-') + print((unsigned long)-n, base);
+  return print((unsigned long)n, base);
+}  // of method print()
+size_t Print::print(const unsigned long n, const int base) {
+  char          buffer[8 * sizeof(long) + 1];
+  char*         p     = &buffer[sizeof(buffer) - 1];
+  unsigned long value = n;
+  *p                  = '\0';
+  do {
+    uint8_t digit = value % (base < 2 ? 10 : base);
+    *--p          = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    value /= (base < 2 ? 10 : base);
+  } while (value);
+  return write(p);
+}  // of method print()
+size_t Print::print(const double n, const int digits) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+  return write(buffer);
+}  // of method print()
+size_t Print::println() { return write("\r\n"); }
@@ -0,0 +1,165 @@
+/*! @file Arduino.h
+ @section Arduino_sim_intro_section Description
+
+Host-side stand-in for the Arduino core header. It provides just enough of the Arduino API (data
+types, PROGMEM helpers, bit macros, timing, digital pins, interrupts and a Serial object) so that the
+MCP7940 library and its example sketches compile with a normal Linux compiler.\n\n
+Time is simulated: millis() and micros() return a virtual clock which only moves forward when
+delay() or delayMicroseconds() is called, when an I2C transaction takes place on the simulated bus
+or when a sketch loop() iteration completes. Each call of micros() or digitalRead() also takes one
+microsecond, as on a 16MHz AVR, so that busy-wait loops make progress. Every simulated device
+registered as a listener is told about elapsed time so that, for example, the simulated MCP7940
+oscillator keeps ticking. millis() can be given a frequency error with simulatorSetMillisSkew().
+
+@section Arduino_sim_license GNU General Public License v3.0
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section Arduino_sim_versions Changelog
+
+Version| Date       | Developer           | Comments
+------ | ---------- | ------------------- | --------
+1.0.0  | 2026-10-16 | agent               | Initial coding of the host simulator
+*/
+#ifndef Arduino_h
+  /** @brief Guard code definition */
+  #define Arduino_h
+  #include <ctype.h>   // toupper() and friends
+  #include <math.h>    // Floating point functions
+  #include <stdint.h>  // Fixed-width integer types
+  #include <stdio.h>   // sprintf() and friends, used by the example sketches
+  #include <stdlib.h>  // abs() and friends
+  #include <string.h>  // memcpy() and strcpy()
+
+typedef bool    boolean;  ///< Arduino alias for bool
+typedef uint8_t byte;     ///< Arduino alias for uint8_t
+
+  /*************************************************************************************************
+  ** PROGMEM is a no-op on the host, flash and RAM share a single address space                   **
+  *************************************************************************************************/
+  #define PROGMEM                                  ///< No separate flash address space
+  #define PSTR(s) (s)                              ///< Strings are ordinary RAM strings
+  #define pgm_read_byte(p) (*(const uint8_t*)(p))  ///< Read a byte "from flash"
+  #define pgm_read_word(p) (*(const uint16_t*)(p)) ///< Read a word "from flash"
+  #define memcpy_P memcpy                          ///< Copy "from flash"
+  #define strcpy_P strcpy                          ///< Copy string "from flash"
+class __FlashStringHelper;                         ///< Opaque type for F() strings
+  #define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))  ///< Flash string macro
+
+  /*************************************************************************************************
+  ** Bit manipulation and other helper macros from the Arduino core                               **
+  *************************************************************************************************/
+  #define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+  #define bitSet(value, bit) ((value) |= (1UL << (bit)))
+  #define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+  #define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+  #define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+  #define B111 7         ///< Binary constant used in the library
+  #define B11111000 248  ///< Binary constant used in the library
+
+const uint8_t SDA{18};           ///< Default SDA pin, value is ignored by the simulator
+const uint8_t SCL{19};           ///< Default SCL pin, value is ignored by the simulator
+const uint8_t LOW{0};            ///< Digital pin level low
+const uint8_t HIGH{1};           ///< Digital pin level high
+const uint8_t INPUT{0};          ///< Pin mode input
+const uint8_t OUTPUT{1};         ///< Pin mode output
+const uint8_t INPUT_PULLUP{2};   ///< Pin mode input with pull-up
+const uint8_t CHANGE{1};         ///< Interrupt on any change
+const uint8_t FALLING{2};        ///< Interrupt on falling edge
+const uint8_t RISING{3};         ///< Interrupt on rising edge
+const uint8_t SIM_PIN_COUNT{64}; ///< Number of simulated digital pins
+
+  /*************************************************************************************************
+  ** Timing, digital pins and interrupts, all driven by the simulated clock                      **
+  *************************************************************************************************/
+uint32_t millis();
+uint32_t micros();
+void     delay(const uint32_t ms);
+void     delayMicroseconds(const uint32_t us);
+void     pinMode(const uint8_t pin, const uint8_t mode);
+void     digitalWrite(const uint8_t pin, const uint8_t level);
+int      digitalRead(const uint8_t pin);
+void     attachInterrupt(const uint8_t interruptNumber, void (*isr)(), const uint8_t mode);
+void     detachInterrupt(const uint8_t interruptNumber);
+inline uint8_t digitalPinToInterrupt(const uint8_t pin) { return pin; }  ///< 1:1 mapping on host
+inline void    interrupts() {}    ///< Interrupts are never disabled on the host
+inline void    noInterrupts() {}  ///< Interrupts are never disabled on the host
+
+class SimClockListener {
+  /*!
+   @class   SimClockListener
+   @brief   Base class for simulated devices which need to know when virtual time passes
+   @details Listeners register themselves on construction and are called in construction order
+  */
+ public:
+  SimClockListener();
+  virtual ~SimClockListener();
+  virtual void elapse(const uint32_t us) = 0;  ///< Called whenever the virtual clock advances
+};  // of class SimClockListener
+uint64_t simulatorMicros();                              // 64-bit virtual time in microseconds
+void     simulatorAdvance(const uint32_t us);            // Advance the virtual clock
+void     simulatorSetPin(const uint8_t pin, const uint8_t level);  // Drive an input pin
+void     simulatorSetMillisSkew(const int32_t ppm);      // Make millis() run fast or slow
+
+class Print {
+  /*!
+   @class   Print
+   @brief   Minimal version of the Arduino "Print" class writing to the host's stdout
+  */
+ public:
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t c);
+  size_t         write(const char* str);
+  size_t         print(const __FlashStringHelper* str);
+  size_t         print(const char* str);
+  size_t         print(const char c);
+  size_t         print(const long n, const int base = 10);
+  size_t         print(const unsigned long n, const int base = 10);
+  size_t         print(const int n, const int base = 10) { return print((long)n, base); }
+  size_t         print(const unsigned n, const int base = 10) { return print((unsigned long)n, base); }
+  size_t         print(const short n, const int base = 10) { return print((long)n, base); }
+  size_t print(const unsigned short n, const int base = 10) { return print((unsigned long)n, base); }
+  size_t print(const unsigned char n, const int base = 10) { return print((unsigned long)n, base); }
+  size_t print(const signed char n, const int base = 10) { return print((long)n, base); }
+  size_t         print(const double n, const int digits = 2);
+  size_t         println();
+  template <typename T>
+  size_t println(const T value) {
+    /*!
+     @brief     print a value followed by a newline
+     @param[in] value Any type accepted by print()
+     @return    number of characters written
+    */
+    size_t n = print(value);
+    return n + println();
+  }  // of method println()
+  template <typename T>
+  size_t println(const T value, const int format) {
+    /*!
+     @brief     print a value in the given base or precision followed by a newline
+     @param[in] value  Any type accepted by print()
+     @param[in] format Base or number of digits
+     @return    number of characters written
+    */
+    size_t n = print(value, format);
+    return n + println();
+  }  // of method println()
+};   // of class Print
+class HardwareSerial : public Print {
+  /*!
+   @class   HardwareSerial
+   @brief   Serial port stand-in, output goes to stdout and there is never any input
+  */
+ public:
+  void begin(const uint32_t baud) { (void)baud; }  ///< Speed is meaningless on the host
+  int  available() { return 0; }                   ///< No input is ever available
+  int  read() { return -1; }                       ///< No input is ever available
+  explicit operator bool() const { return true; }  ///< Port is always ready
+};  // of class HardwareSerial
+extern HardwareSerial Serial;  ///< Standard Arduino Serial object
+#endif
@@ -0,0 +1,399 @@
+/*! @file MCP7940_Simulator.cpp
+ @section MCP7940_Simulator_cpp_intro_section Description
+
+Implementation of the simulated MCP7940 RTC. See "MCP7940_Simulator.h" for details.
+*/
+#include "MCP7940_Simulator.h"
+
+static const uint8_t RTCC_ADDRESS{0x6F};    ///< RTCC and SRAM I2C address
+static const uint8_t EEPROM_ADDRESS{0x57};  ///< EEPROM and EUI I2C address
+static uint8_t       fromBCD(const uint8_t bcd) { return (bcd >> 4) * 10 + (bcd & 0x0F); }
+static uint8_t       toBCD(const uint8_t dec) { return (dec / 10) << 4 | (dec % 10); }
+static uint8_t       nextPointer(const uint8_t p) {
+  /*!
+   @brief     Return the next RTCC address pointer value
+   @details   The RTCC block rolls over from 0x1F to 0x00 and the SRAM from 0x5F to 0x20
+   @param[in] p Current pointer
+   @return    Pointer after one auto-increment
+  */
+  if (p == 0x1F) return 0x00;
+  if (p == 0x5F) return 0x20;
+  return p + 1;
+}  // of function nextPointer()
+
+MCP7940_Simulator::MCP7940_Simulator(const bool hasEUI) : _hasEUI(hasEUI) {
+  memset(_eeprom, 0xFF, sizeof(_eeprom));
+  memset(_eui, 0xFF, sizeof(_eui));
+  reset();
+}  // of constructor MCP7940_Simulator()
+void MCP7940_Simulator::reset() {
+  /*!
+   @brief   Set all registers to their power-on-reset values, SRAM is cleared
+  */
+  memset(_reg, 0, sizeof(_reg));
+  _reg[0x03] = 0x01;  // RTCWKDAY
+  _reg[0x04] = 0x01;  // RTCDATE
+  _reg[0x05] = 0x21;  // RTCMTH, January with LPYR set as 2000 is a leap year
+  _reg[0x07] = 0x80;  // CONTROL, OUT set
+  _pointer    = 0;
+  _running    = false;
+  _subSecond  = 0;
+  _nacks      = 0;
+  _shortReads = 0;
+  updateMFP();
+}  // of method reset()
+uint8_t MCP7940_Simulator::peek(const uint8_t reg) const {
+  /*!
+   @brief     Read a register without any bus traffic
+   @param[in] reg Register address 0x00-0x5F
+   @return    Register contents as seen over I2C
+  */
+  return readRegister(reg);
+}  // of method peek()
+void MCP7940_Simulator::poke(const uint8_t reg, const uint8_t value) {
+  /*!
+   @brief     Write a register without any bus traffic and bypassing the write rules
+   @param[in] reg   Register address 0x00-0x5F
+   @param[in] value Raw value to store
+  */
+  if (reg < sizeof(_reg)) _reg[reg] = value;
+  if (reg == 0x03) _running = value & 0x20;
+  updateMFP();
+}  // of method poke()
+uint8_t MCP7940_Simulator::peekEEPROM(const uint8_t addr) const {
+  return addr >= 0xF0 ? _eui[addr & 0x07] : _eeprom[addr & 0x7F];
+}  // of method peekEEPROM()
+void MCP7940_Simulator::pokeEEPROM(const uint8_t addr, const uint8_t value) {
+  if (addr >= 0xF0) {
+    _eui[addr & 0x07] = value;
+  } else {
+    _eeprom[addr & 0x7F] = value;
+  }  // of if-then-else protected area
+}  // of method pokeEEPROM()
+void MCP7940_Simulator::connectMFP(const uint8_t pin) {
+  /*!
+   @brief     Drive a simulated digital input pin from the MFP output
+   @param[in] pin Pin number, interrupts attached to it fire on MFP edges
+  */
+  _mfpPin = pin;
+  simulatorSetPin(pin, _mfpLevel);
+}  // of method connectMFP()
+bool MCP7940_Simulator::acknowledges(const uint8_t address) const {
+  return address == RTCC_ADDRESS || (_hasEUI && address == EEPROM_ADDRESS);
+}  // of method acknowledges()
+uint8_t MCP7940_Simulator::readRegister(const uint8_t reg) const {
+  /*!
+   @brief     Return a register as seen over I2C
+   @param[in] reg Register address
+   @return    Register value with reserved and mirrored bits applied
+  */
+  if (reg == 0x09 || reg == 0x10 || reg == 0x17 || reg >= sizeof(_reg)) return 0x00;
+  if (reg == 0x14) return (_reg[0x14] & 0x7F) | (_reg[0x0D] & 0x80);  // ALMPOL mirrors ALM0
+  return _reg[reg];
+}  // of method readRegister()
+void MCP7940_Simulator::writeRegister(const uint8_t reg, const uint8_t value) {
+  /*!
+   @brief     Apply the datasheet write rules for one register
+   @param[in] reg   Register address
+   @param[in] value Value written over I2C
+  */
+  switch (reg) {
+    case 0x00:  // RTCSEC, starting the oscillator restarts the divider chain
+      if ((value & 0x80) && !(_reg[0x00] & 0x80)) {
+        _startupLeft = _startupMicros;
+        _subSecond   = 0;
+      }  // of if-then oscillator being started
+      if (!(value & 0x80)) {
+        _running = false;
+        _reg[0x03] &= ~0x20;  // OSCRUN clears
+      }  // of if-then oscillator being stopped
+      _reg[0x00] = value;
+      break;
+    case 0x01:  // RTCMIN
+    case 0x02:  // RTCHOUR
+      _reg[reg] = value & 0x7F;
+      break;
+    case 0x03:  // RTCWKDAY, OSCRUN is read-only and PWRFAIL can only be cleared
+      if ((_reg[0x03] & 0x10) && !(value & 0x10)) {
+        memset(&_reg[0x18], 0, 8);  // Clearing PWRFAIL resets the time-stamps
+      }  // of if-then PWRFAIL cleared
+      _reg[0x03] = (value & 0x0F) | (_reg[0x03] & (0x20 | (value & 0x10)));
+      break;
+    case 0x04:  // RTCDATE
+      _reg[0x04] = value & 0x3F;
+      break;
+    case 0x05:  // RTCMTH, LPYR is read-only
+      _reg[0x05] = (value & 0x1F) | (_reg[0x05] & 0x20);
+      break;
+    case 0x09:  // EEUNLOCK
+      if (value == 0x55) {
+        _unlock = 1;
+      } else {
+        _unlock = (value == 0xAA && _unlock == 1) ? 2 : 0;
+      }  // of if-then-else first unlock byte
+      break;
+    case 0x0A:  // ALMxSEC
+    case 0x11:
+    case 0x0B:  // ALMxMIN
+    case 0x12:
+    case 0x0C:  // ALMxHOUR
+    case 0x13:
+      _reg[reg] = value & 0x7F;
+      break;
+    case 0x0D:  // ALMxWKDAY, ALMxIF can only be cleared and only ALM0 holds ALMPOL
+    case 0x14:
+      _reg[reg] = (value & (reg == 0x0D ? 0xF7 : 0x77)) | (_reg[reg] & value & 0x08);
+      break;
+    case 0x0E:  // ALMxDATE
+    case 0x15:
+      _reg[reg] = value & 0x3F;
+      break;
+    case 0x0F:  // ALMxMTH
+    case 0x16:
+      _reg[reg] = value & 0x1F;
+      break;
+    case 0x10:  // Reserved
+    case 0x17:
+      break;
+    default:
+      if (reg >= 0x18 && reg <= 0x1F) break;  // Power-fail time-stamps are read-only
+      if (reg < sizeof(_reg)) _reg[reg] = value;  // CONTROL, OSCTRIM and SRAM
+  }  // of switch for each register
+}  // of method writeRegister()
+bool MCP7940_Simulator::i2cWrite(const uint8_t address, const uint8_t* data, const uint8_t len) {
+  /*!
+   @brief     Handle a write transaction
+   @details   The first byte sets the address pointer and every further byte is written with
+              auto-increment. A transaction without data is an address probe
+   @param[in] address I2C address the master sent
+   @param[in] data    Payload bytes
+   @param[in] len     Number of payload bytes
+   @return    true if the device acknowledged every byte, false for a write set up to fail with
+              nackWrites(), which changes nothing
+  */
+  if (len == 0) return true;
+  if (_nacks) {
+    --_nacks;
+    return false;
+  }  // of if-then injected NACK
+  if (address == RTCC_ADDRESS) {
+    _pointer = data[0];
+    for (uint8_t i = 1; i < len; ++i) {
+      writeRegister(_pointer, data[i]);
+      _pointer = nextPointer(_pointer);
+    }  // of for-next each data byte
+    updateMFP();
+    return true;
+  }  // of if-then RTCC access
+  _eePointer = data[0];
+  if (_eePointer >= 0xF0 && _eePointer <= 0xF7) {  // Protected EUI area needs unlocking
+    if (_unlock == 2 && len > 1) {
+      for (uint8_t i = 1; i < len; ++i) {
+        _eui[_eePointer & 0x07] = data[i];
+        _eePointer              = 0xF0 | ((_eePointer + 1) & 0x07);
+      }  // of for-next each data byte
+    }    // of if-then unlocked
+    if (len > 1) _unlock = 0;  // Any write attempt relocks the area
+    return true;
+  }  // of if-then protected area
+  for (uint8_t i = 1; i < len; ++i) {  // Page write, wraps within the 8 byte page
+    _eeprom[_eePointer & 0x7F] = data[i];
+    _eePointer                 = (_eePointer & 0xF8) | ((_eePointer + 1) & 0x07);
+  }  // of for-next each data byte
+  return true;
+}  // of method i2cWrite()
+size_t MCP7940_Simulator::i2cRead(const uint8_t address, uint8_t* data, const uint8_t len) {
+  /*!
+   @brief     Handle a read transaction starting at the current address pointer
+   @param[in]  address I2C address the master sent
+   @param[out] data    Buffer for the bytes read
+   @param[in]  len     Number of bytes requested
+   @return     Number of bytes returned, "len" or one less for a read set up with shortenReads()
+  */
+  uint8_t count = len;
+  if (_shortReads && count) {
+    --_shortReads;
+    --count;
+  }  // of if-then injected short read
+  for (uint8_t i = 0; i < count; ++i) {
+    if (address == RTCC_ADDRESS) {
+      data[i]  = readRegister(_pointer);
+      _pointer = nextPointer(_pointer);
+    } else if (_eePointer >= 0xF0) {
+      data[i]    = _eui[_eePointer & 0x07];
+      _eePointer = 0xF0 | ((_eePointer + 1) & 0x07);
+    } else {
+      data[i]    = _eeprom[_eePointer & 0x7F];
+      _eePointer = (_eePointer + 1) & 0x7F;
+    }  // of if-then-else which memory block
+  }    // of for-next each byte
+  return count;
+}  // of method i2cRead()
+void MCP7940_Simulator::elapse(const uint32_t us) {
+  /*!
+   @brief     Advance the oscillator by the elapsed virtual time
+   @details   The RTC runs at 1 + (crystal error + trim) ppm of real time. Each full second
+              increments the time registers, each half second may toggle the 1Hz MFP output
+   @param[in] us Elapsed microseconds
+  */
+  uint32_t left = us;
+  if (!(_reg[0x00] & 0x80)) return;  // Oscillator disabled
+  if (!_running) {                   // Oscillator still starting up
+    if (left < _startupLeft) {
+      _startupLeft -= left;
+      return;
+    }  // of if-then still starting
+    left -= _startupLeft;
+    _running = true;
+    _reg[0x03] |= 0x20;  // OSCRUN
+  }                      // of if-then oscillator starting
+  uint8_t trim    = _reg[0x08];
+  double  trimPPM = (trim & 0x7F) * 2 * 1e6 / (32768.0 * 60.0) * ((trim & 0x80) ? 1 : -1);
+  double  rtcUs   = left * (1.0 + (_crystalPPM + trimPPM) / 1e6);
+  while (rtcUs > 0) {
+    double boundary = _subSecond < 500000 ? 500000 : 1000000;
+    if (_subSecond + rtcUs < boundary) {
+      _subSecond += rtcUs;
+      break;
+    }  // of if-then no boundary crossed
+    rtcUs -= boundary - _subSecond;
+    _subSecond = boundary;
+    if (boundary == 1000000) {
+      _subSecond = 0;
+      tick();
+    }  // of if-then full second
+    updateMFP();
+  }  // of while time left
+}  // of method elapse()
+void MCP7940_Simulator::tick() {
+  /*!
+   @brief   Increment the timekeeping registers by one second and evaluate the alarms
+  */
+  static const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  uint8_t              changed       = 1;  // Bit mask of changed fields: sec,min,hour,day
+  uint8_t              sec           = fromBCD(_reg[0x00] & 0x7F) + 1;
+  if (sec >= 60) {
+    sec     = 0;
+    changed = 3;
+    uint8_t min = fromBCD(_reg[0x01] & 0x7F) + 1;
+    if (min >= 60) {
+      min          = 0;
+      changed      = 7;
+      bool newDay  = false;
+      uint8_t hour = _reg[0x02];
+      if (hour & 0x40) {  // 12 hour mode
+        uint8_t h  = fromBCD(hour & 0x1F) + 1;
+        bool    pm = hour & 0x20;
+        if (h == 12) {
+          pm     = !pm;
+          newDay = !pm;
+        }  // of if-then AM/PM flips
+        if (h == 13) h = 1;
+        hour = 0x40 | (pm ? 0x20 : 0x00) | toBCD(h);
+      } else {
+        uint8_t h = fromBCD(hour & 0x3F) + 1;
+        if (h >= 24) {
+          h      = 0;
+          newDay = true;
+        }  // of if-then midnight
+        hour = toBCD(h);
+      }  // of if-then-else 12 hour mode
+      _reg[0x02] = hour;
+      if (newDay) {
+        changed      = 15;
+        uint8_t wday = (_reg[0x03] & 0x07) % 7 + 1;
+        _reg[0x03]   = (_reg[0x03] & 0xF8) | wday;
+        uint8_t year = fromBCD(_reg[0x06]);
+        uint8_t mth  = fromBCD(_reg[0x05] & 0x1F);
+        uint8_t date = fromBCD(_reg[0x04] & 0x3F) + 1;
+        uint8_t dim  = daysInMonth[(mth + 11) % 12] + ((mth == 2 && year % 4 == 0) ? 1 : 0);
+        if (date > dim) {
+          date = 1;
+          if (++mth > 12) {
+            mth  = 1;
+            year = (year + 1) % 100;
+          }  // of if-then new year
+        }    // of if-then new month
+        _reg[0x04] = toBCD(date);
+        _reg[0x05] = toBCD(mth) | (year % 4 == 0 ? 0x20 : 0x00);
+        _reg[0x06] = toBCD(year);
+      }  // of if-then new day
+    }    // of if-then new hour
+    _reg[0x01] = toBCD(min);
+  }  // of if-then new minute
+  _reg[0x00] = (_reg[0x00] & 0x80) | toBCD(sec);
+  checkAlarm(0, changed);
+  checkAlarm(1, changed);
+}  // of method tick()
+void MCP7940_Simulator::checkAlarm(const uint8_t alarm, const uint8_t changed) {
+  /*!
+   @brief     Set ALMxIF if an enabled alarm matches
+   @details   An alarm triggers when the field(s) it compares change into the matching value
+   @param[in] alarm   Alarm number 0 or 1
+   @param[in] changed Bit mask of the fields changed by this tick, bit 0 seconds to bit 3 day
+  */
+  if (!(_reg[0x07] & (0x10 << alarm))) return;  // ALMxEN clear
+  const uint8_t* a     = &_reg[0x0A + 7 * alarm];
+  bool           match = false;
+  switch ((a[3] >> 4) & 0x07) {
+    case 0: match = (changed & 1) && (a[0] & 0x7F) == (_reg[0x00] & 0x7F); break;
+    case 1: match = (changed & 2) && (a[1] & 0x7F) == (_reg[0x01] & 0x7F); break;
+    case 2: match = (changed & 4) && (a[2] & 0x7F) == (_reg[0x02] & 0x7F); break;
+    case 3: match = (changed & 8) && (a[3] & 0x07) == (_reg[0x03] & 0x07); break;
+    case 4: match = (changed & 8) && (a[4] & 0x3F) == (_reg[0x04] & 0x3F); break;
+    case 7:
+      match = (a[0] & 0x7F) == (_reg[0x00] & 0x7F) && (a[1] & 0x7F) == (_reg[0x01] & 0x7F) &&
+              (a[2] & 0x7F) == (_reg[0x02] & 0x7F) && (a[3] & 0x07) == (_reg[0x03] & 0x07) &&
+              (a[4] & 0x3F) == (_reg[0x04] & 0x3F) && (a[5] & 0x1F) == (_reg[0x05] & 0x1F);
+      break;
+  }  // of switch on alarm mask
+  if (match) _reg[0x0D + 7 * alarm] |= 0x08;
+}  // of method checkAlarm()
+void MCP7940_Simulator::updateMFP() {
+  /*!
+   @brief   Recompute the MFP output level and drive the connected pin
+  */
+  uint8_t control = _reg[0x07];
+  uint8_t level   = (control >> 7) & 1;  // General purpose output, OUT bit
+  if (control & 0x40) {                  // Square wave output
+    bool oneHz = (control & 0x07) == 0;
+    level      = (oneHz && _running) ? (_subSecond < 500000) : 1;
+  } else if (control & 0x30) {  // Alarm output
+    bool pol = _reg[0x0D] & 0x80;
+    bool if0 = (control & 0x10) && (_reg[0x0D] & 0x08);
+    bool if1 = (control & 0x20) && (_reg[0x14] & 0x08);
+    if ((control & 0x30) == 0x30) {
+      level = pol ? (if0 || if1) : !(if0 && if1);
+    } else {
+      level = pol ? (if0 || if1) : !(if0 || if1);
+    }  // of if-then-else both alarms enabled
+  }    // of if-then-else MFP mode
+  _mfpLevel = level;
+  if (_mfpPin >= 0) simulatorSetPin((uint8_t)_mfpPin, level);
+}  // of method updateMFP()
+void MCP7940_Simulator::powerFail(const uint32_t seconds) {
+  /*!
+   @brief     Simulate a loss of primary power
+   @details   With VBATEN set the oscillator keeps running from the battery, the power-down and
+              power-up time-stamps are captured and PWRFAIL is set. Without battery backup the
+              device is reset to its power-on state. The virtual MCU clock does not advance
+   @param[in] seconds Length of the outage
+  */
+  if (!(_reg[0x03] & 0x08)) {
+    reset();
+    return;
+  }  // of if-then no battery backup
+  uint8_t* stamp = &_reg[0x18];
+  for (uint8_t i = 0; i < 2; ++i) {
+    stamp[0] = _reg[0x01];
+    stamp[1] = _reg[0x02];
+    stamp[2] = _reg[0x04];
+    stamp[3] = (_reg[0x05] & 0x1F) | (_reg[0x03] & 0x07) << 5;
+    if (i == 0 && _running) {
+      for (uint32_t s = 0; s < seconds; ++s) tick();
+    }  // of if-then outage
+    stamp += 4;
+  }  // of for-next power-down and power-up
+  _reg[0x03] |= 0x10;  // PWRFAIL
+  updateMFP();
+}  // of method powerFail()
@@ -0,0 +1,76 @@
+/*! @file MCP7940_Simulator.h
+ @section MCP7940_Simulator_intro_section Description
+
+Register-accurate model of the Microchip MCP7940M/N and MCP7940x (MCP79400/401/402) real-time clock
+for host-side testing of the MCP7940 library. It attaches to the simulated "Wire" bus and answers
+on the RTCC address 0x6F and, optionally, on the EEPROM/EUI address 0x57.\n\n
+The following datasheet behavior is modelled:\n
+- The 0x00-0x1F RTCC register block and the 0x20-0x5F SRAM, with the address pointer auto-
+  incrementing and rolling over from 0x1F to 0x00 and from 0x5F to 0x20\n
+- Read-only and unimplemented bits (OSCRUN, LPYR, the power-fail time-stamps, ALM1WKDAY.ALMPOL),
+  PWRFAIL and the ALMxIF flags being clear-only, clearing PWRFAIL resets the time-stamps\n
+- An oscillator with a configurable start-up time and crystal error, trimmed by OSCTRIM\n
+- Seconds-to-year rollover in 24 and 12 hour mode including leap years and the weekday counter\n
+- Both alarms with all match masks setting ALMxIF, and the MFP output in general purpose, alarm
+  and 1Hz square wave modes, optionally driving a simulated input pin\n
+- Power failure with and without battery backup, including the power-fail time-stamps\n
+- The 128 byte EEPROM and the 8 byte protected EUI area with the EEUNLOCK 0x55/0xAA sequence\n
+- Bus errors injected by a test: writes which are not acknowledged and reads which end a byte
+  early\n
+The 4.096kHz, 8.192kHz, 32.768kHz and 64Hz square wave outputs as well as coarse trim mode are not
+modelled on the MFP pin.
+*/
+#ifndef MCP7940_Simulator_h
+  /** @brief Guard code definition */
+  #define MCP7940_Simulator_h
+  #include "Wire.h"
+
+class MCP7940_Simulator : public SimI2CDevice, public SimClockListener {
+  /*!
+   @class   MCP7940_Simulator
+   @brief   Simulated MCP7940 RTC attached to a simulated TwoWire bus
+  */
+ public:
+  explicit MCP7940_Simulator(const bool hasEUI = true);
+  void    reset();
+  uint8_t peek(const uint8_t reg) const;
+  void    poke(const uint8_t reg, const uint8_t value);
+  uint8_t peekEEPROM(const uint8_t addr) const;
+  void    pokeEEPROM(const uint8_t addr, const uint8_t value);
+  void    setCrystalError(const double ppm) { _crystalPPM = ppm; }  ///< Crystal error in ppm
+  void    setStartupTime(const uint32_t us) { _startupMicros = us; }  ///< Oscillator start time
+  void    connectMFP(const uint8_t pin);
+  uint8_t mfp() const { return _mfpLevel; }           ///< Current MFP output level
+  double  subSecondMicros() const { return _subSecond; }  ///< Position within current second
+  void    powerFail(const uint32_t seconds);
+  void    nackWrites(const uint8_t count) { _nacks = count; }  ///< Don't acknowledge next writes
+  void    shortenReads(const uint8_t count) { _shortReads = count; }  ///< End next reads early
+  bool    acknowledges(const uint8_t address) const override;
+  bool    i2cWrite(const uint8_t address, const uint8_t* data, const uint8_t len) override;
+  size_t  i2cRead(const uint8_t address, uint8_t* data, const uint8_t len) override;
+  void    elapse(const uint32_t us) override;
+
+ private:
+  uint8_t  _reg[0x60];          ///< RTCC registers and SRAM
+  uint8_t  _eeprom[0x80];       ///< User EEPROM on the MCP7940x
+  uint8_t  _eui[8];             ///< Protected EUI EEPROM
+  bool     _hasEUI;             ///< true for the MCP79400/401/402
+  uint8_t  _pointer{0};         ///< RTCC address pointer
+  uint8_t  _eePointer{0};       ///< EEPROM address pointer
+  uint8_t  _unlock{0};          ///< EEUNLOCK sequence state
+  bool     _running{false};     ///< Oscillator running (OSCRUN)
+  uint32_t _startupLeft{0};     ///< Remaining oscillator start-up time
+  uint32_t _startupMicros{1500};///< Oscillator start-up time
+  double   _crystalPPM{0};      ///< Crystal frequency error in ppm
+  double   _subSecond{0};       ///< Microseconds into the current RTC second
+  int16_t  _mfpPin{-1};         ///< Simulated pin driven by MFP, -1 if none
+  uint8_t  _mfpLevel{1};        ///< Current MFP level
+  uint8_t  _nacks{0};           ///< Number of writes still to be refused
+  uint8_t  _shortReads{0};      ///< Number of reads still to be cut short
+  void     writeRegister(const uint8_t reg, const uint8_t value);
+  uint8_t  readRegister(const uint8_t reg) const;
+  void     tick();
+  void     checkAlarm(const uint8_t alarm, const uint8_t changed);
+  void     updateMFP();
+};  // of class MCP7940_Simulator
+#endif
@@ -0,0 +1,30 @@
+/*! @file SketchRunner.cpp
+ @section SketchRunner_intro_section Description
+
+Host-side "main()" which runs an Arduino sketch against the simulated MCP7940. The sketch's setup()
+is called once and loop() is then called until the requested amount of virtual time has passed.
+Each loop() iteration advances the virtual clock by 10 microseconds so that sketches which spin
+without calling delay() still make progress. On exit the bus statistics are written to stderr.\n\n
+Usage: "sketch [seconds] [mfp-pin]", where "seconds" is the virtual run time (default 10) and
+"mfp-pin" is the digital pin the simulated MFP output drives (default: not connected)
+*/
+#include "MCP7940_Simulator.h"
+
+void setup();  // Provided by the sketch
+void loop();   // Provided by the sketch
+
+MCP7940_Simulator simulatedRTC;  ///< The simulated device on the first bus
+
+int main(int argc, char** argv) {
+  uint32_t seconds = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10;
+  if (argc > 2) simulatedRTC.connectMFP((uint8_t)strtoul(argv[2], nullptr, 10));
+  Wire.attach(simulatedRTC);
+  setup();
+  while (simulatorMicros() < seconds * 1000000ULL) {
+    loop();
+    simulatorAdvance(10);
+  }  // of while time left
+  fflush(stdout);
+  Wire.printStatistics("Wire");
+  return 0;
+}  // of function main()
@@ -0,0 +1,113 @@
+/*! @file Wire.cpp
+ @section Wire_sim_cpp_intro_section Description
+
+Host-side implementation of the simulated "Wire" I2C bus. See the simulator's "Wire.h" for details.
+*/
+#include "Wire.h"
+
+TwoWire Wire;   ///< First simulated bus
+TwoWire Wire1;  ///< Second simulated bus
+
+TwoWire::TwoWire() {}
+bool TwoWire::attach(SimI2CDevice& device) {
+  /*!
+   @brief     Connect a simulated device to this bus
+   @param[in] device Device to attach
+   @return    true on success, false if the bus is full
+  */
+  if (_deviceCount >= MAX_DEVICES) return false;
+  _devices[_deviceCount++] = &device;
+  return true;
+}  // of method attach()
+SimI2CDevice* TwoWire::find(const uint8_t address) const {
+  /*!
+   @brief     Return the device that acknowledges the address
+   @param[in] address 7-bit I2C address
+   @return    Pointer to the device or nullptr if nobody answers
+  */
+  for (uint8_t i = 0; i < _deviceCount; ++i) {
+    if (_devices[i]->acknowledges(address)) return _devices[i];
+  }  // of for-next each device
+  return nullptr;
+}  // of method find()
+void TwoWire::account(const uint8_t payload, const bool acked) {
+  /*!
+   @brief     Update the statistics and virtual clock for one transaction
+   @details   A transaction consists of a START bit, the address byte, the payload bytes each with
+              their ACK/NACK bit, and a STOP bit. An unacknowledged transaction ends right after the
+              address byte
+   @param[in] payload Number of payload bytes transferred
+   @param[in] acked   false if no device acknowledged the address
+  */
+  uint32_t bits = 1 + 9 * (1 + (acked ? payload : 0)) + 1;
+  ++_stats.transactions;
+  _stats.bytes += acked ? payload : 0;
+  _stats.bits += bits;
+  if (!acked) ++_stats.nacks;
+  simulatorAdvance((bits * 1000000UL + _clockHz - 1) / _clockHz);
+}  // of method account()
+void TwoWire::beginTransmission(const uint8_t address) {
+  _txAddress = address;
+  _txLength  = 0;
+}  // of method beginTransmission()
+size_t TwoWire::write(const uint8_t data) {
+  if (_txLength >= BUFFER_LENGTH) return 0;  // Buffer full, byte is silently dropped
+  _txBuffer[_txLength++] = data;
+  return 1;
+}  // of method write()
+size_t TwoWire::write(const uint8_t* data, const size_t quantity) {
+  size_t n = 0;
+  while (n < quantity && write(data[n])) ++n;
+  return n;
+}  // of method write()
+uint8_t TwoWire::endTransmission(const bool sendStop) {
+  /*!
+   @brief     Send the buffered bytes
+   @param[in] sendStop Ignored, repeated starts cost the same number of bits as STOP+START
+   @return    0 on success, 2 if the address was not acknowledged, 3 if data was not acknowledged
+  */
+  (void)sendStop;
+  ++_stats.writes;
+  SimI2CDevice* device = find(_txAddress);
+  if (device == nullptr) {
+    account(_txLength, false);
+    return 2;
+  }  // of if-then nobody home
+  bool ok = device->i2cWrite(_txAddress, _txBuffer, _txLength);
+  account(_txLength, true);
+  return ok ? 0 : 3;
+}  // of method endTransmission()
+uint8_t TwoWire::requestFrom(const int address, const int quantity, const int sendStop) {
+  /*!
+   @brief     Read bytes from a device into the receive buffer
+   @param[in] address  7-bit I2C address
+   @param[in] quantity Number of bytes requested, truncated to BUFFER_LENGTH
+   @param[in] sendStop Ignored
+   @return    Number of bytes actually received
+  */
+  (void)sendStop;
+  ++_stats.reads;
+  _rxIndex             = 0;
+  _rxLength            = 0;
+  uint8_t       length = quantity > BUFFER_LENGTH ? BUFFER_LENGTH : (uint8_t)quantity;
+  SimI2CDevice* device = find((uint8_t)address);
+  if (device == nullptr) {
+    account(0, false);
+    return 0;
+  }  // of if-then nobody home
+  _rxLength = (uint8_t)device->i2cRead((uint8_t)address, _rxBuffer, length);
+  account(_rxLength, true);
+  return _rxLength;
+}  // of method requestFrom()
+int TwoWire::read() { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1; }
+void TwoWire::printStatistics(const char* name) const {
+  /*!
+   @brief     Write the bus statistics to stderr
+   @param[in] name Label for the bus
+  */
+  fprintf(stderr,
+          "%s: %u transactions (%u writes, %u reads, %u NACK), %u bytes, %llu us @100kHz, "
+          "%llu us @400kHz\n",
+          name, _stats.transactions, _stats.writes, _stats.reads, _stats.nacks, _stats.bytes,
+          (unsigned long long)_stats.microsAt(100000), (unsigned long long)_stats.microsAt(400000));
+}  // of method printStatistics()
@@ -0,0 +1,90 @@
+/*! @file Wire.h
+ @section Wire_sim_intro_section Description
+
+Host-side stand-in for the Arduino "Wire" (TwoWire) library. Instead of driving real pins, every
+transaction is handed to the simulated I2C devices attached to the bus. The class mimics the
+behavior of the AVR implementation that matters to drivers: a BUFFER_LENGTH byte transmit and
+receive buffer (longer writes are silently truncated), endTransmission() status codes and
+requestFrom() returning the number of bytes actually received.\n\n
+Each bus keeps statistics of the number of transactions, bytes moved and bus bit-times. The bus
+time is reported for both 100kHz standard mode and 400kHz fast mode regardless of the clock speed
+selected with setClock(), while the virtual clock is advanced by the time a transaction would take
+at the selected speed.
+*/
+#ifndef TwoWire_h
+  /** @brief Guard code definition */
+  #define TwoWire_h
+  #include "Arduino.h"
+  #ifndef BUFFER_LENGTH
+    #define BUFFER_LENGTH 32  ///< Size of the transmit and receive buffers, as on AVR
+  #endif
+
+class SimI2CDevice {
+  /*!
+   @class   SimI2CDevice
+   @brief   Interface implemented by every simulated I2C slave device
+  */
+ public:
+  virtual ~SimI2CDevice() {}
+  virtual bool   acknowledges(const uint8_t address) const = 0;  ///< true if address is ours
+  virtual bool   i2cWrite(const uint8_t address, const uint8_t* data, const uint8_t len) = 0;
+  virtual size_t i2cRead(const uint8_t address, uint8_t* data, const uint8_t len)        = 0;
+};  // of class SimI2CDevice
+
+struct SimBusStatistics {
+  /*!
+   @struct  SimBusStatistics
+   @brief   Cumulative traffic counters for one simulated bus
+  */
+  uint32_t transactions{0};  ///< Number of START..STOP transactions
+  uint32_t writes{0};        ///< Number of write transactions (endTransmission)
+  uint32_t reads{0};         ///< Number of read transactions (requestFrom)
+  uint32_t bytes{0};         ///< Payload bytes moved, excluding the I2C address byte
+  uint32_t nacks{0};         ///< Transactions not acknowledged by any device
+  uint64_t bits{0};          ///< Bus bit-times, including START, address, ACK and STOP bits
+  uint64_t microsAt(const uint32_t clockHz) const {  ///< Bus time at the given clock speed
+    return (bits * 1000000ULL + clockHz - 1) / clockHz;
+  }
+};  // of struct SimBusStatistics
+
+class TwoWire {
+  /*!
+   @class   TwoWire
+   @brief   Simulated I2C bus master with the Arduino "Wire" interface
+  */
+ public:
+  TwoWire();
+  void    begin() {}                                          ///< Nothing to initialize
+  void    begin(const uint8_t, const uint8_t) {}              ///< Pins are ignored
+  void    setClock(const uint32_t clockHz) { _clockHz = clockHz; }  ///< Set bus speed
+  void    beginTransmission(const uint8_t address);
+  size_t  write(const uint8_t data);
+  size_t  write(const uint8_t* data, const size_t quantity);
+  uint8_t endTransmission(const bool sendStop = true);
+  uint8_t requestFrom(const int address, const int quantity, const int sendStop = 1);
+  int     available() const { return _rxLength - _rxIndex; }  ///< Bytes left to read
+  int     read();
+  int     peek() const { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex] : -1; }
+  bool    attach(SimI2CDevice& device);
+  void    resetStatistics() { _stats = SimBusStatistics(); }      ///< Zero all counters
+  const SimBusStatistics& statistics() const { return _stats; }  ///< Cumulative counters
+  void                    printStatistics(const char* name) const;
+
+ private:
+  static const uint8_t MAX_DEVICES{4};     ///< Devices per bus
+  SimI2CDevice*        _devices[MAX_DEVICES]{};  ///< Attached devices
+  uint8_t              _deviceCount{0};    ///< Number of attached devices
+  uint32_t             _clockHz{100000};   ///< Selected bus speed
+  uint8_t              _txAddress{0};      ///< Address of current write transaction
+  uint8_t              _txBuffer[BUFFER_LENGTH];  ///< Transmit buffer
+  uint8_t              _txLength{0};       ///< Bytes in transmit buffer
+  uint8_t              _rxBuffer[BUFFER_LENGTH];  ///< Receive buffer
+  uint8_t              _rxLength{0};       ///< Bytes in receive buffer
+  uint8_t              _rxIndex{0};        ///< Read position in receive buffer
+  SimBusStatistics     _stats;             ///< Traffic counters
+  SimI2CDevice*        find(const uint8_t address) const;
+  void                 account(const uint8_t payload, const bool acked);
+};  // of class TwoWire
+extern TwoWire Wire;   ///< First simulated bus
+extern TwoWire Wire1;  ///< Second simulated bus, for multi-bus setups
+#endif
@@ -0,0 +1,1057 @@
+/*! @file SimulatorTests.cpp
+ @section SimulatorTests_intro_section Description
+
+Host-side behaviour tests of the MCP7940 library, built with a normal Linux compiler against the
+host simulator in "extras/simulator". Each test sets up the simulated device, drives the library
+through a scenario in virtual time and checks the results. Unlike the example sketches, which
+print what they do, a test checks conditions which can't be seen by looking at a single output
+line, such as the error of the cached clock over a day.\n\n
+One line is written per test with "PASS" or "FAIL", every failed check is written with its line
+number and condition. The exit code is 1 if any check failed.\n\n
+Usage: "SimulatorTests"
+
+@section SimulatorTests_license GNU General Public License v3.0
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section SimulatorTests_versions Changelog
+
+Version| Date       | Developer           | Comments
+------ | ---------- | ------------------- | --------
+1.0.0  | 2026-10-17 | agent               | Initial coding
+*/
+#include "MCP7940.h"
+#include "MCP7940_Simulator.h"
+
+/** @brief Check a condition and report it with its line number if it is false */
+#define CHECK(condition) check(condition, #condition, __LINE__)
+
+MCP7940_Simulator simulatedRTC;   ///< The simulated device on the first bus
+MCP7940_Simulator secondRTC;      ///< Simulated device on the second bus, "Wire1"
+MCP7940_Class     rtc;            ///< Library instance under test, reset by run()
+uint16_t          testFailures;   ///< Failed checks in the current test
+uint16_t          totalFailures;  ///< Failed checks in all tests
+
+bool check(const bool condition, const char* text, const int line) {
+  /*!
+   @brief     Record the result of one check
+   @param[in] condition Result of the check
+   @param[in] text      Source text of the condition
+   @param[in] line      Source line of the check
+   @return    The condition, so that a test can stop on a failed precondition
+  */
+  if (!condition) {
+    printf("  line %d: CHECK(%s) failed\n", line, text);
+    ++testFailures;
+  }  // of if-then check failed
+  return condition;
+}  // of function check()
+
+void run(const char* name, void (*test)()) {
+  /*!
+   @brief     Run one test against a freshly reset device and write its result line
+   @details   The simulated device is reset to its power-on state and "rtc" to a newly constructed
+              instance on which begin() has been called. The oscillator isn't running until the
+              test sets the time with rtc.adjust() or starts it
+   @param[in] name Test name
+   @param[in] test Function performing the test
+  */
+  simulatedRTC.reset();
+  simulatedRTC.setStartupTime(1500);
+  simulatedRTC.setCrystalError(0);
+  simulatorSetMillisSkew(0);
+  rtc = MCP7940_Class();
+  rtc.begin();
+  testFailures = 0;
+  test();
+  printf("%s %s\n", testFailures ? "FAIL" : "PASS", name);
+  totalFailures += testFailures;
+}  // of function run()
+
+int32_t difference(const DateTime& a, const DateTime& b) {
+  /*!
+   @brief     Return the difference of two date/times in seconds
+   @param[in] a First date/time
+   @param[in] b Second date/time
+   @return    a - b in seconds
+  */
+  return (int32_t)(a.unixtime() - b.unixtime());
+}  // of function difference()
+uint8_t refBcd2int(const uint8_t bcd) { return bcd / 16 * 10 + bcd % 16; }  ///< Division-based
+uint8_t refInt2bcd(const uint8_t dec) { return dec / 10 * 16 + dec % 10; }  ///< Division-based
+void    testCodecReference() {
+  /*!
+   @brief     Compare the BCD conversions exhaustively with the original division-based code
+   @details   bcd2int() and int2bcd() are checked for all 256 byte values. decodeTime() and
+              encodeTime() are checked for all 256 values of every field, each one in 256 blocks
+              whose other fields are pseudo-random. Build with -DMCP7940_SWAR64 to check the 64
+              bit conversions
+  */
+  uint32_t mismatches[4]{0};
+  for (uint16_t b = 0; b < 256; ++b) {
+    if (MCP7940_Codec::bcd2int(b) != refBcd2int(b)) ++mismatches[0];
+    if (MCP7940_Codec::int2bcd(b) != refInt2bcd(b)) ++mismatches[1];
+  }  // of for-next each byte value
+  const uint8_t fields[6] = {0, 1, 2, 4, 5, 6};  // RTCWKDAY is ignored
+  uint32_t      random{1};                       // Linear congruential generator state
+  for (uint8_t f = 0; f < 6; ++f) {
+    for (uint16_t b = 0; b < 256; ++b) {
+      for (uint16_t r = 0; r < 256; ++r) {
+        uint8_t block[7], value[6];
+        for (uint8_t i = 0; i < 7; ++i) block[i] = (random = random * 1664525 + 1013904223) >> 24;
+        for (uint8_t i = 0; i < 6; ++i) value[i] = (random = random * 1664525 + 1013904223) >> 24;
+        block[fields[f]]  = b;
+        value[f]          = b;
+        const DateTime dt = MCP7940_Codec::decodeTime(block);
+        if (dt.year() != refBcd2int(block[6]) + 2000 || dt.month() != refBcd2int(block[5] & 0x1F) ||
+            dt.day() != refBcd2int(block[4] & 0x3F) || dt.hour() != refBcd2int(block[2] & 0x3F) ||
+            dt.minute() != refBcd2int(block[1] & 0x7F) ||
+            dt.second() != refBcd2int(block[0] & 0x7F)) {
+          ++mismatches[2];
+        }  // of if-then decoded fields differ
+        const DateTime in(2000 + value[5], value[4], value[3], value[2], value[1], value[0]);
+        MCP7940_Codec::encodeTime(in, in.dayOfTheWeek(), block);
+        if (block[0] != (refInt2bcd(value[0]) | 0x80) || block[1] != refInt2bcd(value[1]) ||
+            block[2] != refInt2bcd(value[2]) || block[3] != in.dayOfTheWeek() ||
+            block[4] != refInt2bcd(value[3]) || block[5] != refInt2bcd(value[4]) ||
+            block[6] != refInt2bcd(value[5])) {
+          ++mismatches[3];
+        }  // of if-then encoded registers differ
+      }    // of for-next each random block
+    }      // of for-next each field value
+  }        // of for-next each field
+  CHECK(mismatches[0] == 0);  // bcd2int()
+  CHECK(mismatches[1] == 0);  // int2bcd()
+  CHECK(mismatches[2] == 0);  // decodeTime()
+  CHECK(mismatches[3] == 0);  // encodeTime()
+}  // of function testCodecReference()
+
+void nowCacheSkew(const int32_t ppm) {
+  /*!
+   @brief     Run the cached clock for one day with a millis() frequency error
+   @details   now() is called once a second with a resync interval of ten minutes. The cached
+              time may drift by the millis() error between two resyncs, but the error must not
+              accumulate over the day and the time must never go backwards
+   @param[in] ppm millis() error in parts per million
+  */
+  MCP7940_Class device;  // Cache off, always reads the device
+  rtc.adjust(DateTime(2026, 10, 17, 0, 0, 0));
+  rtc.setNowCache(600000);
+  simulatorSetMillisSkew(ppm);
+  int32_t  worst{0};
+  DateTime last = rtc.now();
+  for (uint32_t second = 0; second < 86400; ++second) {
+    delay(1000);
+    const DateTime cached = rtc.now();
+    const int32_t  error  = difference(cached, device.now());
+    if (abs(error) > abs(worst)) worst = error;
+    if (!CHECK(cached.unixtime() >= last.unixtime())) return;  // Monotonic
+    last = cached;
+  }  // of for-next each second of a day
+  CHECK(abs(worst) <= abs(ppm) * 600 / 1000000 + 2);  // Drift in one interval, plus rounding
+}  // of function nowCacheSkew()
+void testNowCacheFastMillis() { nowCacheSkew(5000); }   ///< now() with a fast millis()
+void testNowCacheSlowMillis() { nowCacheSkew(-5000); }  ///< now() with a slow millis()
+void testNowCacheClockTick() {
+  /*!
+   @brief     Align the cached clock to the 1Hz MFP edges for an hour with a fast millis()
+   @details   With clockTick() called on every rising edge the cached time is never more than a
+              second off, as it is re-anchored each second, and never goes backwards
+  */
+  MCP7940_Class device;  // Cache off, always reads the device
+  rtc.adjust(DateTime(2026, 10, 17, 0, 0, 0));
+  rtc.setSQWSpeed(0);  // 1Hz on the MFP pin
+  rtc.setNowCache(600000);
+  simulatorSetMillisSkew(5000);
+  const uint64_t start = simulatorMicros();
+  uint8_t        level = simulatedRTC.mfp();
+  uint16_t       edges{0};
+  int32_t        worst{0};
+  DateTime       last = rtc.now();
+  while (simulatorMicros() - start < 3600000000ULL) {
+    delay(10);
+    if (simulatedRTC.mfp() && !level) {
+      rtc.clockTick();
+      ++edges;
+      const DateTime cached = rtc.now();
+      const int32_t  error  = difference(cached, device.now());
+      if (abs(error) > abs(worst)) worst = error;
+      if (!CHECK(cached.unixtime() >= last.unixtime())) return;  // Monotonic
+      last = cached;
+    }  // of if-then rising edge
+    level = simulatedRTC.mfp();
+  }  // of while less than an hour
+  CHECK(edges >= 3599);
+  CHECK(abs(worst) <= 1);
+}  // of function testNowCacheClockTick()
+
+void testNowCacheSetBack() {
+  /*!
+   @brief     Set the clock back by 10 seconds with the cached clock on
+   @details   now() holds the last value returned while the device is behind it and follows the
+              device again once it has caught up
+  */
+  MCP7940_Class  device;  // Cache off, always reads the device
+  const DateTime start(2026, 10, 17, 12, 0, 0);
+  rtc.adjust(start);
+  rtc.setNowCache(600000);
+  DateTime last = rtc.now();
+  for (uint8_t i = 0; i < 30; ++i) {  // 30 seconds at the original setting
+    delay(1000);
+    if (!CHECK(rtc.now().unixtime() >= last.unixtime())) return;
+    last = rtc.now();
+  }  // of for-next 30 seconds
+  rtc.adjust(start + TimeSpan(20));  // 10 seconds back from now
+  for (uint8_t i = 0; i < 30; ++i) {  // Held for about 10 seconds, then running again
+    delay(500);
+    const DateTime cached = rtc.now();
+    if (!CHECK(cached.unixtime() >= last.unixtime())) return;  // Monotonic
+    last = cached;
+  }  // of for-next 15 seconds
+  CHECK(abs(difference(rtc.now(), device.now())) <= 1);
+}  // of function testNowCacheSetBack()
+void testBurstAdjust() {
+  /*!
+   @brief     adjust() in burst mode keeps VBATEN and PWRFAIL and leaves the oscillator running
+  */
+  rtc.setBattery(true);
+  simulatedRTC.powerFail(60);
+  const DateTime dt(2027, 1, 2, 3, 4, 5);
+  rtc.adjust(dt, true);
+  CHECK(rtc.getBattery());
+  CHECK(rtc.getPowerFail());
+  CHECK(simulatedRTC.peek(MCP7940_RTCSEC) & (1 << MCP7940_ST));
+  CHECK(rtc.weekdayRead() == dt.dayOfTheWeek());
+  CHECK(difference(rtc.now(), dt) == 0);
+  delay(2500);  // Clock is running again
+  CHECK(difference(rtc.now(), dt) == 2);
+}  // of function testBurstAdjust()
+uint32_t secondStart() {
+  /*!
+   @brief     Return the micros() value at which the device's current second started
+  */
+  return micros() - (uint32_t)simulatedRTC.subSecondMicros();
+}  // of function secondStart()
+void testAdjustAtMicros() {
+  /*!
+   @brief     adjustAtMicros() starts the new second at the requested micros() value
+   @details   The simulated device applies a write when it begins, so with no oscillator start-up
+              time the second starts at "atMicros" and the latency is the bus time of the write
+  */
+  const DateTime dt(2026, 10, 17, 12, 0, 0);
+  uint32_t       latency;
+  simulatedRTC.setStartupTime(0);
+  rtc.adjust(DateTime(2026, 1, 1, 0, 0, 0));
+  delay(1300);
+  const uint32_t at = micros() + 20000;
+  if (!CHECK(rtc.adjustAtMicros(dt, at, latency))) return;
+  CHECK(latency > 800 && latency < 900);  // 9 bytes at 100kHz
+  CHECK(secondStart() - at < 5);
+  CHECK((simulatedRTC.peek(MCP7940_RTCWKDAY) & 7) == dt.dayOfTheWeek());
+  CHECK(difference(rtc.now(), dt) == 0);
+  delay(1000 - (micros() - at) / 1000 - 2);  // Just before the next second
+  CHECK(difference(rtc.now(), dt) == 0);
+  delay(3);
+  CHECK(difference(rtc.now(), dt) == 1);
+}  // of function testAdjustAtMicros()
+const uint8_t PPS_PIN{3};  ///< Simulated pin driven by the reference pulse
+class PulseGenerator : public SimClockListener {
+  /*!
+   @class   PulseGenerator
+   @brief   1Hz reference pulse on PPS_PIN, high for the first 100ms of every virtual second
+  */
+ public:
+  bool enabled{true};  ///< false to hold the pin low
+  void elapse(const uint32_t) override {
+    simulatorSetPin(PPS_PIN, enabled && simulatorMicros() % 1000000 < 100000 ? HIGH : LOW);
+  }  // of method elapse()
+};   // of class PulseGenerator
+void testAdjustOnEdge() {
+  /*!
+   @brief     adjustOnEdge() starts the new second on the next rising edge of the reference, and
+              restarts the clock with the old time when no edge arrives
+   @details   The call is made while the pulse is high, so the edge it must wait for is the next one
+  */
+  PulseGenerator pps;
+  const DateTime old(2026, 1, 1, 0, 0, 0), dt(2026, 10, 17, 12, 0, 0);
+  uint32_t       latency;
+  simulatedRTC.setStartupTime(0);
+  rtc.adjust(old);
+  delay(1000 - simulatorMicros() % 1000000 / 1000 + 50);  // 50ms into a pulse
+  const uint32_t edge = simulatorMicros() / 1000000 * 1000000 + 1000000;  // As micros()
+  if (!CHECK(rtc.adjustOnEdge(dt, PPS_PIN, latency))) return;
+  CHECK(latency > 800 && latency < 900);  // 9 bytes at 100kHz
+  CHECK(secondStart() - edge < 5);
+  CHECK(difference(rtc.now(), dt) == 0);
+  delay(1000);
+  CHECK(difference(rtc.now(), dt) == 1);
+  pps.enabled = false;
+  rtc.adjust(old);
+  const uint32_t start = millis();
+  CHECK(!rtc.adjustOnEdge(dt, PPS_PIN, latency, 50));
+  CHECK(millis() - start >= 50 && millis() - start < 60);
+  CHECK(simulatedRTC.peek(MCP7940_RTCSEC) & (1 << MCP7940_ST));  // Running again
+  CHECK(difference(rtc.now(), old) == 0);
+}  // of function testAdjustOnEdge()
+void testCacheAlarmFlag() {
+  /*!
+   @brief     An alarm which fires after the cache was filled survives alarm bit updates
+   @details   setAlarmPolarity() and setAlarmState() must not write back a stale ALMxIF flag
+  */
+  const DateTime dt(2026, 10, 17, 12, 0, 0);
+  rtc.adjust(dt);
+  rtc.setCache(true);
+  rtc.refreshCache();
+  rtc.setAlarm(0, 0, dt + TimeSpan(2), true);  // Match on seconds
+  delay(3000);
+  CHECK(simulatedRTC.peek(MCP7940_ALM0WKDAY) & (1 << MCP7940_ALM0IF));  // Fired, cache not read
+  rtc.setAlarmPolarity(true);
+  rtc.setAlarmState(0, true);
+  rtc.setAlarmState(1, false);
+  CHECK(rtc.isAlarm(0));
+  CHECK(simulatedRTC.peek(MCP7940_ALM0WKDAY) & (1 << MCP7940_ALM0IF));
+  CHECK(simulatedRTC.peek(MCP7940_ALM0WKDAY) & (1 << MCP7940_ALMPOL));
+}  // of function testCacheAlarmFlag()
+void testBusRetries() {
+  /*!
+   @brief     Failed and short transfers are repeated up to the number of retries and counted
+  */
+  const DateTime set(2026, 10, 17, 12, 0, 0);
+  DateTime       dt;
+  rtc.adjust(set);
+  rtc.setRetryPolicy(3);
+  simulatedRTC.nackWrites(2);
+  CHECK(rtc.now(dt) && difference(dt, set) == 0);
+  CHECK(rtc.getRetryCount() == 2);
+  CHECK(rtc.getLastError() == MCP7940_ERROR_NONE);
+  simulatedRTC.shortenReads(1);
+  CHECK(rtc.now(dt) && difference(dt, set) == 0);
+  CHECK(rtc.getRetryCount() == 3);
+  CHECK(rtc.getErrorCount() == 0);
+  simulatedRTC.nackWrites(4);  // One more than the retries
+  CHECK(!rtc.now(dt));
+  CHECK(rtc.getRetryCount() == 6);
+  CHECK(rtc.getErrorCount() == 1);
+  CHECK(rtc.getLastError() == MCP7940_ERROR_NACK);
+  CHECK(rtc.getLastError() == MCP7940_ERROR_NONE);  // Cleared when read
+}  // of function testBusRetries()
+void testBusErrorValues() {
+  /*!
+   @brief     Without retries the getters return their documented values on a bus error, and the
+              overloads with an output parameter return false
+  */
+  DateTime dt;
+  uint8_t  value, alarmType;
+  int8_t   trim;
+  rtc.adjust(DateTime(2026, 10, 17, 12, 0, 0));
+  rtc.setSQWSpeed(1);
+  simulatedRTC.shortenReads(1);
+  CHECK(!rtc.now(dt) && dt.year() == 2000 && dt.month() == 1 && dt.day() == 1);
+  CHECK(rtc.getLastError() == MCP7940_ERROR_SHORT_READ);
+  simulatedRTC.nackWrites(1);
+  CHECK(rtc.weekdayRead() == 0);
+  simulatedRTC.nackWrites(1);
+  CHECK(!rtc.weekdayRead(value) && value == 0);
+  simulatedRTC.nackWrites(1);
+  CHECK(!rtc.getSQWSpeed(value) && value == 0);
+  CHECK(rtc.getSQWSpeed(value) && value == 1);
+  simulatedRTC.nackWrites(1);
+  CHECK(!rtc.getAlarm(0, dt, alarmType) && dt.month() == 0);
+  CHECK(!rtc.getAlarm(2, dt, alarmType));  // Bad alarm number
+  simulatedRTC.nackWrites(1);
+  CHECK(!rtc.getBattery());
+  DateTime up;
+  simulatedRTC.nackWrites(1);
+  CHECK(!rtc.getPowerFailTimes(dt, up));
+  CHECK(rtc.getErrorCount() == 7);
+  rtc.setCache(true);
+  CHECK(rtc.refreshCache());
+  simulatedRTC.nackWrites(1);
+  CHECK(rtc.getCalibrationTrim(trim) && trim == 0);  // From the cache, no bus traffic
+}  // of function testBusErrorValues()
+void testBusDeadline() {
+  /*!
+   @brief     Retries stop at the call's deadline, so a read on a failing bus takes at most the
+              deadline plus one transfer
+  */
+  DateTime dt;
+  rtc.adjust(DateTime(2026, 10, 17, 12, 0, 0));
+  rtc.setRetryPolicy(250, 2000);
+  simulatedRTC.nackWrites(250);
+  const uint32_t start = micros();
+  CHECK(!rtc.now(dt));
+  const uint32_t took = micros() - start;
+  CHECK(rtc.getLastError() == MCP7940_ERROR_DEADLINE);
+  CHECK(rtc.getRetryCount() > 0 && rtc.getRetryCount() < 250);
+  CHECK(rtc.getErrorCount() == 1);
+  CHECK(took >= 2000 && took < 2000 + 1000);
+}  // of function testBusDeadline()
+void testRAMBlock() {
+  /*!
+   @brief     readRAMBlock() and writeRAMBlock() split the whole SRAM into buffer-sized chunks and
+              wrap around from address 63 to 0
+   @details   With the 32 byte buffer a 64 byte read takes 2 transactions and a 64 byte write 3,
+              each write chunk carrying the address byte and 31 data bytes
+  */
+  const uint8_t reads  = (MCP7940_RAM_SIZE + BUFFER_LENGTH - 1) / BUFFER_LENGTH;
+  const uint8_t writes = (MCP7940_RAM_SIZE + BUFFER_LENGTH - 2) / (BUFFER_LENGTH - 1);
+  uint8_t data[MCP7940_RAM_SIZE + 8], back[MCP7940_RAM_SIZE + 8];
+  for (uint8_t i = 0; i < sizeof(data); ++i) data[i] = 0xA0 ^ i;
+  Wire.resetStatistics();
+  CHECK(rtc.writeRAMBlock(50, data, sizeof(data)) == MCP7940_RAM_SIZE);  // Limited to the SRAM
+  CHECK(Wire.statistics().writes == writes && Wire.statistics().reads == 0);
+  uint8_t wrong{0};
+  for (uint8_t i = 0; i < MCP7940_RAM_SIZE; ++i) {
+    if (simulatedRTC.peek(MCP7940_RAM_ADDRESS + (50 + i) % MCP7940_RAM_SIZE) != data[i]) ++wrong;
+  }  // of for-next each SRAM byte
+  CHECK(wrong == 0);
+  memset(back, 0, sizeof(back));
+  Wire.resetStatistics();
+  CHECK(rtc.readRAMBlock(10, back, sizeof(back)) == MCP7940_RAM_SIZE);
+  CHECK(Wire.statistics().reads == reads);
+  for (uint8_t i = 0; i < MCP7940_RAM_SIZE; ++i) {
+    if (back[i] != data[(i + MCP7940_RAM_SIZE + 10 - 50) % MCP7940_RAM_SIZE]) ++wrong;
+  }  // of for-next each byte read
+  CHECK(wrong == 0);
+  CHECK(back[MCP7940_RAM_SIZE] == 0);  // Nothing past the SRAM size
+  Wire.resetStatistics();
+  CHECK(rtc.readRAMBlock(MCP7940_RAM_SIZE + 60, back, 8) == 8);  // Address 60, wraps to 0-3
+  CHECK(Wire.statistics().reads == 1);
+  for (uint8_t i = 0; i < 8; ++i) {
+    if (back[i] != simulatedRTC.peek(MCP7940_RAM_ADDRESS + (60 + i) % MCP7940_RAM_SIZE)) ++wrong;
+  }  // of for-next each byte read
+  CHECK(wrong == 0);
+}  // of function testRAMBlock()
+void testTwoBuses() {
+  /*!
+   @brief     Instances on "Wire" and "Wire1" each talk only to the device on their own bus
+  */
+  MCP7940_Class  second(Wire1);
+  const DateTime first(2026, 10, 17, 12, 0, 0), other(2031, 5, 6, 7, 8, 9);
+  secondRTC.reset();
+  CHECK(second.begin());
+  rtc.adjust(first);
+  second.adjust(other);
+  rtc.setSQWSpeed(3);
+  second.writeRAM(5, (uint8_t)0x5A);
+  CHECK(simulatedRTC.peek(MCP7940_RAM_ADDRESS + 5) == 0);
+  CHECK(secondRTC.peek(MCP7940_RAM_ADDRESS + 5) == 0x5A);
+  CHECK(rtc.getSQWSpeed() == 3 && second.getSQWSpeed() == 0);
+  CHECK(difference(rtc.now(), first) == 0 && difference(second.now(), other) == 0);
+  Wire1.resetStatistics();
+  rtc.now();
+  CHECK(Wire1.statistics().transactions == 0);
+  second.deviceStop();  // Only the clock on the second bus stops
+  delay(2000);
+  CHECK(difference(rtc.now(), first) == 2 && difference(second.now(), other) == 0);
+  CHECK(!(secondRTC.peek(MCP7940_RTCSEC) & (1 << MCP7940_ST)));
+  CHECK(simulatedRTC.peek(MCP7940_RTCSEC) & (1 << MCP7940_ST));
+  secondRTC.reset();
+}  // of function testTwoBuses()
+bool sameTime(const DateTime& a, const DateTime& b) {
+  /*!
+   @brief     Compare all fields of two date/times, which need not be valid dates
+  */
+  return a.year() == b.year() && a.month() == b.month() && a.day() == b.day() &&
+         a.hour() == b.hour() && a.minute() == b.minute() && a.second() == b.second();
+}  // of function sameTime()
+void testSnapshot() {
+  /*!
+   @brief     readSnapshot() reads all 32 registers in buffer-sized chunks and its accessors return
+              what the individual getters return
+   @details   The 32 registers fit the default buffer in one read, build with -DBUFFER_LENGTH=16 to
+              check the split into two reads
+  */
+  const DateTime dt(2026, 10, 17, 12, 0, 0);
+  rtc.adjust(dt);
+  rtc.setBattery(true);
+  rtc.setAlarm(0, 0, dt + TimeSpan(2), true);  // Fires, match on seconds
+  rtc.setAlarm(1, 7, DateTime(2027, 2, 3, 4, 5, 6), false);
+  rtc.setSQWSpeed(2);
+  rtc.calibrate((int8_t)-12);
+  simulatedRTC.powerFail(3600);
+  delay(3000);
+  MCP7940_Snapshot snapshot;
+  Wire.resetStatistics();
+  if (!CHECK(rtc.readSnapshot(snapshot) && snapshot.valid())) return;
+  CHECK(Wire.statistics().reads == (MCP7940_SNAPSHOT_SIZE + BUFFER_LENGTH - 1) / BUFFER_LENGTH);
+  uint8_t wrong{0};
+  for (uint8_t reg = 0; reg < MCP7940_SNAPSHOT_SIZE; ++reg) {
+    if (snapshot.getRegister(reg) != simulatedRTC.peek(reg)) ++wrong;
+  }  // of for-next each register
+  CHECK(wrong == 0);
+  CHECK(sameTime(snapshot.now(), rtc.now()));
+  CHECK(snapshot.deviceStatus() == rtc.deviceStatus());
+  CHECK(snapshot.weekdayRead() == rtc.weekdayRead());
+  CHECK(snapshot.getCalibrationTrim() == -12 && rtc.getCalibrationTrim() == -12);
+  CHECK(snapshot.getMFP() == rtc.getMFP());
+  for (uint8_t alarm = 0; alarm < 2; ++alarm) {
+    uint8_t fromSnapshot, fromDevice;
+    CHECK(sameTime(snapshot.getAlarm(alarm, fromSnapshot), rtc.getAlarm(alarm, fromDevice)));
+    CHECK(fromSnapshot == fromDevice);
+    CHECK(snapshot.getAlarmState(alarm) == rtc.getAlarmState(alarm));
+    CHECK(snapshot.isAlarm(alarm) == rtc.isAlarm(alarm));
+  }  // of for-next each alarm
+  CHECK(snapshot.isAlarm(0) && !snapshot.isAlarm(1));
+  CHECK(snapshot.getSQWSpeed() == 2 && rtc.getSQWSpeed() == 2);
+  CHECK(snapshot.getSQWState() == rtc.getSQWState());
+  CHECK(snapshot.getBattery() && rtc.getBattery());
+  CHECK(snapshot.getPowerFail() && rtc.getPowerFail());
+  CHECK(sameTime(snapshot.getPowerDown(), rtc.getPowerDown()));
+  CHECK(sameTime(snapshot.getPowerUp(), rtc.getPowerUp()));
+  simulatedRTC.shortenReads(1);
+  CHECK(!rtc.readSnapshot(snapshot) && !snapshot.valid());
+}  // of function testSnapshot()
+const uint32_t STUCK{0xFFFFFFFF};  ///< Oscillator start-up time which never ends in a test
+uint8_t        asyncOrder[8];      ///< Handles in the order the callback saw them
+uint8_t        asyncStatus[8];     ///< Final status of each handle seen by the callback
+uint8_t        asyncCalls;         ///< Number of callback calls
+
+void asyncCallback(const uint8_t handle, const uint8_t status) {
+  /*!
+   @brief     Record a completed MCP7940_Async operation
+   @param[in] handle Handle of the operation
+   @param[in] status Final status
+  */
+  if (asyncCalls < sizeof(asyncOrder)) {
+    asyncOrder[asyncCalls]  = handle;
+    asyncStatus[asyncCalls] = status;
+  }  // of if-then room to record
+  ++asyncCalls;
+}  // of function asyncCallback()
+uint32_t pollAll(MCP7940_Async& async) {
+  /*!
+   @brief     Call poll() until the queue is empty or 2 seconds have passed
+   @return    The longest time a single poll() took, in microseconds
+  */
+  uint32_t       longest{0};
+  const uint64_t start = simulatorMicros();
+  while (async.pending() && simulatorMicros() - start < 2000000) {
+    const uint64_t before = simulatorMicros();
+    async.poll();
+    const uint32_t took = simulatorMicros() - before;
+    if (took > longest) longest = took;
+    delayMicroseconds(100);  // The rest of loop()
+  }  // of while operations pending
+  return longest;
+}  // of function pollAll()
+void testAsyncSequence() {
+  /*!
+   @brief     Queue start, adjust, setAlarm and now and check they complete in order
+   @details   Every poll() must be a step of at most a few I2C transactions, the oscillator
+              start-up is waited for across several polls
+  */
+  MCP7940_Async async(rtc);
+  simulatedRTC.setStartupTime(20000);  // 20ms, so that the start spans several polls
+  asyncCalls = 0;
+  async.setCallback(asyncCallback);
+  const uint8_t start = async.start();
+  const uint8_t set   = async.adjust(DateTime(2026, 10, 17, 8, 0, 0));
+  const uint8_t alarm = async.setAlarm(1, 7, DateTime(2026, 10, 17, 8, 30, 15));
+  const uint8_t now   = async.now();
+  if (!CHECK(start && set && alarm && now)) return;
+  CHECK(async.pending() == 4);
+  CHECK(pollAll(async) < 5000);
+  CHECK(asyncCalls == 4);
+  CHECK(asyncOrder[0] == start && asyncOrder[1] == set && asyncOrder[2] == alarm &&
+        asyncOrder[3] == now);
+  for (uint8_t i = 0; i < 4; ++i) CHECK(asyncStatus[i] == MCP7940_ASYNC_DONE);
+  DateTime dt;
+  CHECK(async.result(now, dt) && dt.year() == 2026 && dt.hour() == 8 && dt.minute() == 0);
+  CHECK(!async.result(alarm, dt));  // Only now() returns a date/time
+  CHECK(simulatedRTC.peek(MCP7940_ALM1SEC) == 0x15 && simulatedRTC.peek(MCP7940_ALM1MIN) == 0x30);
+  CHECK((simulatedRTC.peek(MCP7940_ALM1WKDAY) & 0x70) == 0x70);
+  CHECK(simulatedRTC.peek(MCP7940_CONTROL) >> MCP7940_ALM1EN & 1);
+}  // of function testAsyncSequence()
+void testAsyncStuckOscillator() {
+  /*!
+   @brief     An oscillator which never starts fails the operations after the timeout
+   @details   Each poll() stays short while the OSCRUN bit is waited for, the alarm registers are
+              not written and the operations queued after the failed one still run
+  */
+  MCP7940_Async async(rtc);
+  simulatedRTC.setStartupTime(STUCK);
+  asyncCalls = 0;
+  async.setCallback(asyncCallback);
+  const uint64_t begun = simulatorMicros();
+  const uint8_t  alarm = async.setAlarm(0, 7, DateTime(2026, 10, 17, 9, 0, 0));
+  const uint8_t  set   = async.adjust(DateTime(2026, 10, 17, 8, 0, 0));
+  const uint8_t  now   = async.now();
+  CHECK(pollAll(async) < 5000);
+  CHECK(asyncCalls == 3);
+  CHECK(async.status(alarm) == MCP7940_ASYNC_FAILED);
+  CHECK(async.status(set) == MCP7940_ASYNC_FAILED);
+  CHECK(async.status(now) == MCP7940_ASYNC_DONE);
+  const uint32_t took = (simulatorMicros() - begun) / 1000;
+  CHECK(took >= 2 * MCP7940_ASYNC_TIMEOUT && took < 4 * MCP7940_ASYNC_TIMEOUT);
+  CHECK(simulatedRTC.peek(MCP7940_ALM0MIN) == 0);  // Alarm never written
+  CHECK(!(simulatedRTC.peek(MCP7940_CONTROL) >> MCP7940_ALM0EN & 1));
+}  // of function testAsyncStuckOscillator()
+void testAsyncNoWait() {
+  /*!
+   @brief     The final steps of setAlarm and now never wait on the device
+   @details   The oscillator is stopped, and can't be restarted, after setAlarm has checked it.
+              The alarm is still written in one short step, as is the now() read with the cached
+              clock due for a resync
+  */
+  MCP7940_Async async(rtc);
+  rtc.adjust(DateTime(2026, 10, 17, 8, 0, 0));
+  rtc.setNowCache(1000);
+  const uint8_t alarm = async.setAlarm(0, 7, DateTime(2026, 10, 17, 9, 0, 0));
+  const uint8_t now   = async.now();
+  async.poll();  // Oscillator is running, the alarm is written on the next poll
+  simulatedRTC.setStartupTime(STUCK);
+  rtc.deviceStop();
+  delay(2000);  // The cached clock is due for a resync
+  CHECK(pollAll(async) < 5000);
+  CHECK(async.status(alarm) == MCP7940_ASYNC_DONE);
+  CHECK(async.status(now) == MCP7940_ASYNC_DONE);
+  CHECK(simulatedRTC.peek(MCP7940_ALM0MIN) == 0x00 && simulatedRTC.peek(MCP7940_ALM0HOUR) == 0x09);
+}  // of function testAsyncNoWait()
+
+const uint8_t     MFP_PIN{2};        ///< Simulated pin driven by the MFP output
+MCP7940_Timebase* timebase{nullptr};  ///< Timebase under test, used by the interrupt routine
+bool              edgesMasked{false};  ///< True to lose edges, as with interrupts off
+volatile uint32_t edgeSeen{0};        ///< micros() at the last edge delivered to the timebase
+
+void timebaseISR() {
+  /*!
+   @brief     Interrupt routine on the rising MFP edge
+  */
+  if (timebase && !edgesMasked) {
+    edgeSeen = micros();
+    timebase->edge();
+  }  // of if-then edge not lost
+}  // of function timebaseISR()
+void runFor(const uint32_t ms) {
+  /*!
+   @brief     Let time pass in small steps
+   @details   The simulated MFP pin changes at the end of each step, so a single long delay() would
+              deliver all of its edges at the same micros() value
+   @param[in] ms Milliseconds to run for
+  */
+  for (uint32_t i = 0; i < ms * 10; ++i) delayMicroseconds(100);
+}  // of function runFor()
+void timebaseAt(const double crystalPPM, const uint32_t afterEdge, uint32_t& micro) {
+  /*!
+   @brief      Run a timebase for 10 seconds and stamp a time at a given offset after an edge
+   @details    The seconds of the stamp are checked against the device, the fraction is returned
+   @param[in]  crystalPPM RTC crystal error, i.e. the negative of the MCU drift against the RTC
+   @param[in]  afterEdge  MCU microseconds after the edge at which the stamp is taken
+   @param[out] micro      Fraction of the second returned by stamp()
+  */
+  MCP7940_Timebase tb(rtc);
+  timebase = &tb;
+  simulatedRTC.setCrystalError(crystalPPM);
+  simulatedRTC.connectMFP(MFP_PIN);
+  attachInterrupt(digitalPinToInterrupt(MFP_PIN), timebaseISR, RISING);
+  rtc.adjust(DateTime(2026, 10, 17, 12, 0, 0));
+  micro = 0;
+  if (CHECK(tb.begin())) {
+    runFor(10000);
+    const uint32_t last = edgeSeen;
+    while (edgeSeen == last) delayMicroseconds(1);  // Start right at the next edge
+    const uint32_t edge = edgeSeen;
+    delayMicroseconds(afterEdge);
+    uint32_t seconds;
+    CHECK(tb.stamp(edge + afterEdge, seconds, micro));
+    CHECK(seconds == rtc.now().unixtime());
+  }  // of if-then timebase started
+  detachInterrupt(digitalPinToInterrupt(MFP_PIN));
+  timebase = nullptr;
+}  // of function timebaseAt()
+void testTimebaseFraction() {
+  /*!
+   @brief     The fraction of a stamp is the time since the last edge in RTC microseconds
+  */
+  uint32_t      micro;
+  timebaseAt(0, 250000, micro);
+  CHECK(micro >= 249990 && micro <= 250010);
+}  // of function testTimebaseFraction()
+void testTimebaseLargeDrift() {
+  /*!
+   @brief     A 4% fast RTC is measured and the fraction scaled without overflow
+   @details   The MCU sees 961538us per RTC second, a drift of -38462ppm. At 900000 MCU
+              microseconds after an edge the RTC is at 936000us
+  */
+  uint32_t      micro;
+  timebaseAt(40000, 900000, micro);
+  CHECK(micro >= 935900 && micro <= 936100);
+}  // of function testTimebaseLargeDrift()
+void testTimebaseMissedEdges() {
+  /*!
+   @brief     Edges lost while interrupts are off are counted from the interval
+   @details   After 3.5 seconds without edges the stamps still match the device seconds and the
+              drift measurement isn't disturbed by the long interval
+  */
+  MCP7940_Timebase tb(rtc);
+  timebase = &tb;
+  simulatedRTC.connectMFP(MFP_PIN);
+  attachInterrupt(digitalPinToInterrupt(MFP_PIN), timebaseISR, RISING);
+  rtc.adjust(DateTime(2026, 10, 17, 12, 0, 0));
+  if (CHECK(tb.begin())) {
+    runFor(5000);
+    edgesMasked = true;
+    runFor(3500);
+    edgesMasked = false;
+    runFor(2500);
+    uint32_t seconds, micro;
+    CHECK(tb.stamp(seconds, micro));
+    CHECK(seconds == rtc.now().unixtime());
+    CHECK(abs(tb.getDrift()) <= 50);  // Only the 100us steps of runFor()
+  }  // of if-then timebase started
+  detachInterrupt(digitalPinToInterrupt(MFP_PIN));
+  timebase = nullptr;
+}  // of function testTimebaseMissedEdges()
+
+void eventLogFill(MCP7940_EventLog& log, const uint32_t records) {
+  /*!
+   @brief     Clear a log and append the numbers 0 to records-1
+   @param[in] log     Event log with a payload of 4 bytes
+   @param[in] records Number of records to append
+  */
+  CHECK(log.clear());
+  for (uint32_t i = 0; i < records; ++i) {
+    if (!CHECK(log.append(i))) return;
+  }  // of for-next each record
+}  // of function eventLogFill()
+bool eventLogHolds(const MCP7940_EventLog& log, const uint32_t oldest, const uint8_t records) {
+  /*!
+   @brief     Check that a log holds consecutive numbers, with read() and with readAll()
+   @param[in] log     Event log with a payload of 4 bytes
+   @param[in] oldest  Expected number in the oldest record
+   @param[in] records Expected number of records
+   @return    True if all records match
+  */
+  uint32_t all[16];
+  bool     ok = CHECK(log.count() == records) && CHECK(log.readAll(all, 16) == records);
+  for (uint8_t i = 0; ok && i < records; ++i) {
+    uint32_t value{0};
+    ok = CHECK(log.read(i, value)) && CHECK(value == oldest + i) && CHECK(all[i] == oldest + i);
+  }  // of for-next each record
+  return ok;
+}  // of function eventLogHolds()
+void testEventLogWrap() {
+  /*!
+   @brief     25 records in a log of 10 slots keep the newest 10 in order, also after a restart
+   @details   A second log object on the same SRAM area stands for the restarted sketch
+  */
+  MCP7940_EventLog log(rtc, sizeof(uint32_t));
+  CHECK(log.capacity() == MCP7940_RAM_SIZE / (sizeof(uint32_t) + 2));
+  eventLogFill(log, 25);
+  eventLogHolds(log, 15, 10);
+  MCP7940_EventLog restarted(rtc, sizeof(uint32_t));
+  CHECK(restarted.begin());
+  CHECK(restarted.sequence() == log.sequence());
+  eventLogHolds(restarted, 15, 10);
+  CHECK(restarted.append((uint32_t)25));
+  eventLogHolds(restarted, 16, 10);
+}  // of function testEventLogWrap()
+void testEventLogSequenceWrap() {
+  /*!
+   @brief     The newest record is found after the 8 bit sequence number has wrapped around
+  */
+  MCP7940_EventLog log(rtc, sizeof(uint32_t));
+  eventLogFill(log, 300);
+  MCP7940_EventLog restarted(rtc, sizeof(uint32_t));
+  CHECK(restarted.begin());
+  CHECK(restarted.sequence() == (uint8_t)299);
+  eventLogHolds(restarted, 290, 10);
+}  // of function testEventLogSequenceWrap()
+void testEventLogTornRecord() {
+  /*!
+   @brief     A newest record torn by a power failure is dropped and the one before is newest
+   @details   Record 24 is in slot 4, its CRC byte is broken. The log then ends with record 23 and
+              reaches back to record 15, the next append reuses slot 4
+  */
+  MCP7940_EventLog log(rtc, sizeof(uint32_t));
+  eventLogFill(log, 25);
+  const uint8_t crc = MCP7940_RAM_ADDRESS + 4 * (sizeof(uint32_t) + 2) + sizeof(uint32_t) + 1;
+  simulatedRTC.poke(crc, simulatedRTC.peek(crc) ^ 0xFF);
+  MCP7940_EventLog restarted(rtc, sizeof(uint32_t));
+  CHECK(restarted.begin());
+  eventLogHolds(restarted, 15, 9);
+  CHECK(restarted.append((uint32_t)24));
+  eventLogHolds(restarted, 15, 10);
+}  // of function testEventLogTornRecord()
+void testEventLogArea() {
+  /*!
+   @brief     A log in part of the SRAM wraps within its area and leaves the rest untouched
+  */
+  MCP7940_EventLog log(rtc, sizeof(uint32_t), 40, 24);
+  uint8_t before[40], after[40];
+  for (uint8_t i = 0; i < 40; ++i) before[i] = i * 7 + 1;
+  rtc.writeRAMBlock(0, before, 40);
+  CHECK(log.capacity() == 4);
+  eventLogFill(log, 11);
+  eventLogHolds(log, 7, 4);
+  rtc.readRAMBlock(0, after, 40);
+  CHECK(memcmp(before, after, 40) == 0);
+}  // of function testEventLogArea()
+
+uint8_t schedulerFired[48];  ///< Ids in the order the callback saw them
+uint8_t schedulerCalls;      ///< Number of callback calls
+
+void schedulerCallback(const uint8_t id) {
+  /*!
+   @brief     Record a fired virtual alarm
+   @param[in] id Id of the alarm
+  */
+  if (schedulerCalls < sizeof(schedulerFired)) schedulerFired[schedulerCalls] = id;
+  ++schedulerCalls;
+}  // of function schedulerCallback()
+void testSchedulerOrder() {
+  /*!
+   @brief     16 alarms added out of order, 3 of them cancelled, fire in time order
+   @details   The alarms are 10 to 160 seconds ahead, added in the order 130,160,30,60,...
+              The alarms at 130 and 90 seconds and then the earliest one are cancelled. One of the
+              cancels moves the heap's last entry into a gap below a later parent, so that it has
+              to move up. Two single alarms and a repeating one take the free places. service()
+              is only called when the MFP output is high, so each alarm must also have been
+              programmed into a hardware alarm at the right time. Each second the alarms due are
+              compared with the expected ones, computed from the list of alarms
+  */
+  MCP7940_Scheduler scheduler(rtc);
+  rtc.adjust(DateTime(2026, 10, 17, 12, 0, 0));
+  simulatedRTC.connectMFP(MFP_PIN);
+  CHECK(scheduler.begin());
+  const DateTime base = rtc.now();
+  uint32_t       offset[MCP7940_SCHEDULER_SIZE + 1]{0};  // Seconds ahead of each id, 0 if unused
+  uint32_t       period[MCP7940_SCHEDULER_SIZE + 1]{0};  // Repeat interval of each id
+  for (uint8_t i = 0; i < MCP7940_SCHEDULER_SIZE; ++i) {
+    const uint32_t ahead = ((i * 3 + 12) % MCP7940_SCHEDULER_SIZE + 1) * 10;
+    const uint8_t  id    = scheduler.add(base + TimeSpan(ahead), 0, schedulerCallback);
+    if (!CHECK(id >= 1 && id <= MCP7940_SCHEDULER_SIZE)) return;
+    offset[id] = ahead;
+  }  // of for-next each alarm
+  CHECK(scheduler.add(base + TimeSpan(5), 0, schedulerCallback) == 0);  // Full
+  uint8_t cancelled[3]{0, 0, 0};  // Ids at 130, 90 and 10 seconds
+  for (uint8_t id = 1; id <= MCP7940_SCHEDULER_SIZE; ++id) {
+    if (offset[id] == 130) cancelled[0] = id;
+    if (offset[id] == 90) cancelled[1] = id;
+    if (offset[id] == 10) cancelled[2] = id;
+  }  // of for-next each id
+  for (uint8_t c = 0; c < 3; ++c) {
+    CHECK(scheduler.cancel(cancelled[c]));
+    CHECK(!scheduler.cancel(cancelled[c]));  // Already cancelled
+    offset[cancelled[c]] = 0;
+  }  // of for-next each cancelled alarm
+  CHECK(scheduler.count() == MCP7940_SCHEDULER_SIZE - 3);
+  const uint32_t added[3][2] = {{5, 0}, {75, 0}, {47, 41}};  // Seconds ahead and period
+  for (uint8_t a = 0; a < 3; ++a) {
+    const uint8_t id = scheduler.add(base + TimeSpan(added[a][0]), added[a][1], schedulerCallback);
+    if (!CHECK(id >= 1 && id <= MCP7940_SCHEDULER_SIZE && offset[id] == 0)) return;
+    offset[id] = added[a][0];
+    period[id] = added[a][1];
+  }  // of for-next each new alarm
+  DateTime first;
+  CHECK(scheduler.next(first) && first.unixtime() == base.unixtime() + 5);
+  schedulerCalls = 0;
+  uint8_t expected{0};
+  for (uint32_t second = 1; second <= 170; ++second) {
+    delay(1000);
+    if (simulatedRTC.mfp()) scheduler.service();
+    for (uint8_t id = 1; id <= MCP7940_SCHEDULER_SIZE; ++id) {  // Alarms due this second
+      if (!offset[id] || second < offset[id]) continue;
+      if (second != offset[id] && (!period[id] || (second - offset[id]) % period[id])) continue;
+      if (!CHECK(schedulerCalls > expected && schedulerFired[expected] == id)) return;
+      ++expected;
+    }  // of for-next each id
+    if (!CHECK(schedulerCalls == expected)) return;  // Nothing fired early
+  }  // of for-next each second
+  CHECK(expected == 19);  // 15 single alarms and the repeating one at 47, 88, 129 and 170
+}  // of function testSchedulerOrder()
+
+DateTime trueTime(const DateTime& base, const uint64_t since) {
+  /*!
+   @brief     Return the exact current time, as from GPS or NTP
+   @param[in] base  Date/time set in the device at the start
+   @param[in] since simulatorMicros() at the start
+   @return    base plus the virtual time since the start, rounded to whole seconds
+  */
+  return base + TimeSpan((int32_t)((simulatorMicros() - since + 500000) / 1000000));
+}  // of function trueTime()
+void testCalibratorOutlier() {
+  /*!
+   @brief     One daily sample with a reference 30 seconds off is ignored
+   @details   The crystal is 20ppm slow. After a week of daily samples the fit uses all samples but
+              the wrong one and the trim corrects the crystal to within 2ppm. A restarted
+              calibrator finds the same fit in the SRAM
+  */
+  MCP7940_Calibrator calibrator(rtc);
+  simulatedRTC.setCrystalError(-20);
+  const DateTime base(2026, 10, 17, 12, 0, 0);
+  rtc.adjust(base);
+  const uint64_t since = simulatorMicros();
+  CHECK(calibrator.begin());
+  CHECK(calibrator.clear());
+  for (uint8_t day = 0; day < 7; ++day) {
+    for (uint8_t hour = 0; day && hour < 24; ++hour) delay(3600000UL);  // A day later
+    const TimeSpan wrong(day == 3 ? 30 : 0);  // Bad reference on the 4th day
+    CHECK(calibrator.addSample(trueTime(base, since) + wrong));
+  }  // of for-next each day
+  CHECK(calibrator.count() == 7);
+  CHECK(calibrator.inliers() == 6);
+  const float corrected = -20 - rtc.getCalibrationTrim() / 0.98304;  // Crystal and trim in ppm
+  CHECK(fabs(corrected) <= 2);
+  MCP7940_Calibrator restarted(rtc);
+  CHECK(restarted.begin());
+  CHECK(restarted.inliers() == calibrator.inliers());
+  CHECK(restarted.getPPM() == calibrator.getPPM());
+}  // of function testCalibratorOutlier()
+void testCalibratorClockSet() {
+  /*!
+   @brief     Samples taken before the clock was set an hour ahead are dropped
+   @details   Three daily samples, then the clock is set and four more daily samples follow. The
+              first sample after the setting doesn't fit the older ones but the next one agrees
+              with it, so only the four newest samples are used. The drift is still found, but three
+              days aren't enough to change the trim
+  */
+  MCP7940_Calibrator calibrator(rtc);
+  simulatedRTC.setCrystalError(-20);
+  const DateTime base(2026, 10, 17, 12, 0, 0);
+  rtc.adjust(base);
+  const uint64_t since = simulatorMicros();
+  CHECK(calibrator.begin());
+  CHECK(calibrator.clear());
+  for (uint8_t day = 0; day < 7; ++day) {
+    for (uint8_t hour = 0; day && hour < 24; ++hour) delay(3600000UL);  // A day later
+    if (day == 3) rtc.adjust(trueTime(base, since) + TimeSpan(3600));
+    CHECK(calibrator.addSample(trueTime(base, since)));
+  }  // of for-next each day
+  CHECK(calibrator.count() == 7);
+  CHECK(calibrator.inliers() == 4);
+  CHECK(fabs(calibrator.getPPM() - 20) <= 6);  // One second in three days is 4ppm
+  CHECK(!calibrator.confident() && rtc.getCalibrationTrim() == 0);  // Too short to trim
+}  // of function testCalibratorClockSet()
+
+void testPowerLogYearBoundary() {
+  /*!
+   @brief     An outage from New Year's Eve to January 3rd spans the two years
+   @details   The outage is simulated with the battery backup on. A restarted log finds it in the
+              SRAM and doesn't log it again, as PWRFAIL was cleared
+  */
+  MCP7940_PowerLog log(rtc);
+  rtc.setBattery(true);
+  rtc.adjust(DateTime(2026, 12, 31, 23, 30, 0));
+  delay(2000);
+  simulatedRTC.powerFail(3UL * 86400);
+  CHECK(rtc.getPowerFail());
+  CHECK(log.begin());
+  CHECK(!rtc.getPowerFail());
+  DateTime down, up;
+  if (CHECK(log.count() == 1) && CHECK(log.read(0, down, up))) {
+    CHECK(down.unixtime() == DateTime(2026, 12, 31, 23, 30, 0).unixtime());
+    CHECK(up.unixtime() == DateTime(2027, 1, 3, 23, 30, 0).unixtime());
+  }  // of if-then outage logged
+  CHECK(log.downtime() == 3 * 1440);
+  MCP7940_PowerLog restarted(rtc);
+  CHECK(restarted.begin());
+  CHECK(restarted.count() == 1 && restarted.downtime() == 3 * 1440);
+}  // of function testPowerLogYearBoundary()
+void powerStamps(const DateTime& down, const DateTime& up) {
+  /*!
+   @brief     Write the power-down and power-up time-stamps into the device and set PWRFAIL
+   @details   Used for outages which are too long to be simulated second by second
+   @param[in] down Power-down date/time, the year is not stored
+   @param[in] up   Power-up date/time, the year is not stored
+  */
+  const DateTime* stamp[2] = {&down, &up};
+  for (uint8_t i = 0; i < 2; ++i) {
+    simulatedRTC.poke(0x18 + 4 * i, MCP7940_Codec::int2bcd(stamp[i]->minute()));
+    simulatedRTC.poke(0x19 + 4 * i, MCP7940_Codec::int2bcd(stamp[i]->hour()));
+    simulatedRTC.poke(0x1A + 4 * i, MCP7940_Codec::int2bcd(stamp[i]->day()));
+    simulatedRTC.poke(0x1B + 4 * i, stamp[i]->dayOfTheWeek() << 5 |
+                                        MCP7940_Codec::int2bcd(stamp[i]->month()));
+  }  // of for-next power-down and power-up
+  simulatedRTC.poke(MCP7940_RTCWKDAY, simulatedRTC.peek(MCP7940_RTCWKDAY) | 1 << MCP7940_PWRFAIL);
+}  // of function powerStamps()
+void testPowerLogLeapDay() {
+  /*!
+   @brief     Power-down time-stamps of February 29 are placed in a leap year
+   @details   The first outage starts on February 29 2028 and ends on March 1, it is captured right
+              after the power-up. The second one starts on February 29 2028 and ends on March 5
+              2029. 2029 isn't a leap year, so the power-down has to be in 2028 even though the
+              date February 29 2029 would be before the power-up. That outage is longer than 45
+              days and its duration saturates
+  */
+  MCP7940_PowerLog log(rtc);
+  rtc.setBattery(true);
+  rtc.adjust(DateTime(2028, 2, 29, 23, 0, 0));
+  delay(2000);
+  simulatedRTC.powerFail(7200);
+  CHECK(log.begin());
+  rtc.adjust(DateTime(2029, 3, 6, 12, 0, 0));
+  powerStamps(DateTime(2028, 2, 29, 10, 0, 0), DateTime(2029, 3, 5, 8, 0, 0));
+  CHECK(log.capture());
+  DateTime down, up;
+  if (CHECK(log.count() == 2) && CHECK(log.read(0, down, up))) {
+    CHECK(down.unixtime() == DateTime(2028, 2, 29, 23, 0, 0).unixtime());
+    CHECK(up.unixtime() == DateTime(2028, 3, 1, 1, 0, 0).unixtime());
+  }  // of if-then first outage logged
+  if (CHECK(log.read(1, down, up))) {
+    CHECK(down.unixtime() == DateTime(2028, 2, 29, 10, 0, 0).unixtime());
+    CHECK(up.unixtime() - down.unixtime() == 65535UL * 60);
+  }  // of if-then second outage logged
+  CHECK(log.downtime() == 120 + 65535UL);
+}  // of function testPowerLogLeapDay()
+void testPowerLogMidnight() {
+  /*!
+   @brief     Clearing PWRFAIL keeps a weekday increment which happens during capture()
+   @details   The outage is captured again and again around midnight, so that the day rolls over
+              at some point between the burst read of the registers and the clearing of PWRFAIL
+  */
+  MCP7940_PowerLog log(rtc);
+  CHECK(log.begin());
+  rtc.adjust(DateTime(2026, 12, 31, 23, 59, 58));
+  delay(1900);
+  for (uint8_t i = 0; i < 100; ++i) {
+    powerStamps(DateTime(2026, 12, 30, 12, 0, 0), DateTime(2026, 12, 31, 12, 0, 0));
+    log.capture();
+    if (!CHECK(rtc.weekdayRead() == rtc.now().dayOfTheWeek())) return;
+    delayMicroseconds(200);
+  }  // of for-next each capture
+  CHECK(rtc.now().day() == 1);  // Rolled over during the loop
+}  // of function testPowerLogMidnight()
+
+int main() {
+  Wire.attach(simulatedRTC);
+  Wire1.attach(secondRTC);
+  run("BCD conversions match the division-based code", testCodecReference);
+  run("now() cache, millis() 0.5% fast", testNowCacheFastMillis);
+  run("now() cache, millis() 0.5% slow", testNowCacheSlowMillis);
+  run("now() cache, clockTick() with millis() 0.5% fast", testNowCacheClockTick);
+  run("adjust() in burst mode", testBurstAdjust);
+  run("adjustAtMicros() second alignment", testAdjustAtMicros);
+  run("adjustOnEdge() on a reference pulse and without one", testAdjustOnEdge);
+  run("Register cache keeps an alarm which fired after the fill", testCacheAlarmFlag);
+  run("Bus retries after NACKs and short reads", testBusRetries);
+  run("Getter values and status on a bus error", testBusErrorValues);
+  run("Bus retries stop at the deadline", testBusDeadline);
+  run("SRAM block transfers in chunks and around the end", testRAMBlock);
+  run("Two devices on different buses", testTwoBuses);
+  run("readSnapshot() chunks and accessors", testSnapshot);
+  run("now() cache, clock set back by adjust()", testNowCacheSetBack);
+  run("MCP7940_Async operations in order", testAsyncSequence);
+  run("MCP7940_Async with an oscillator that never starts", testAsyncStuckOscillator);
+  run("MCP7940_Async final steps don't wait", testAsyncNoWait);
+  run("MCP7940_Timebase fraction of a second", testTimebaseFraction);
+  run("MCP7940_Timebase with a 4% drift", testTimebaseLargeDrift);
+  run("MCP7940_Timebase missed edges", testTimebaseMissedEdges);
+  run("MCP7940_EventLog wraparound and restart", testEventLogWrap);
+  run("MCP7940_EventLog sequence number wraparound", testEventLogSequenceWrap);
+  run("MCP7940_EventLog torn newest record", testEventLogTornRecord);
+  run("MCP7940_EventLog in part of the SRAM", testEventLogArea);
+  run("MCP7940_Scheduler order across cancels", testSchedulerOrder);
+  run("MCP7940_Calibrator ignores an outlier", testCalibratorOutlier);
+  run("MCP7940_Calibrator drops samples before the clock was set", testCalibratorClockSet);
+  run("MCP7940_PowerLog outage over the year end", testPowerLogYearBoundary);
+  run("MCP7940_PowerLog outages from February 29", testPowerLogLeapDay);
+  run("MCP7940_PowerLog capture over midnight", testPowerLogMidnight);
+  return totalFailures ? 1 : 0;
+}  // of function main()
@@ -50,6 +50,30 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 
 Version| Date       | Developer           | Comments
 ------ | ---------- | ------------------- | --------
+1.3.0  | 2026-10-17 | agent               | Added integer calibrate(counts,gateMicros), fixed calibrate(float) recursion, 64Hz in getSQWSpeed()
+1.3.0  | 2026-10-17 | agent               | Division-free SWAR BCD conversion of the timekeeping block, 64 bit version opt-in
+1.3.0  | 2026-10-17 | agent               | Added host benchmark of DateTime math and per-method bus cost
+1.3.0  | 2026-10-17 | agent               | Added MCP7940_Timebase microsecond timestamps from the 1Hz MFP edge
+1.3.0  | 2026-10-17 | agent               | Added MCP7940_PowerLog outage history captured at startup
+1.3.0  | 2026-10-16 | agent               | Added MCP7940_Calibrator least-squares drift fit over SRAM samples
+1.3.0  | 2026-10-16 | agent               | Added MCP7940_Scheduler virtual alarms on a min-heap over ALM0/ALM1
+1.3.0  | 2026-10-16 | agent               | Added readSnapshot() and MCP7940_Snapshot, one burst read of 0x00-0x1F
+1.3.0  | 2026-10-17 | agent               | Added bus retry policy, getLastError(), setBusTimeout() and getters returning a status
+1.3.0  | 2026-10-17 | agent               | Transport class template MCP7940_Base, MCP7940_Class uses MCP7940_WireTransport
+1.3.0  | 2026-10-16 | agent               | Constructor takes the TwoWire bus, allowing devices on several buses
+1.3.0  | 2026-10-16 | agent               | Added adjustAtMicros() and adjustOnEdge() second-aligned clock set
+1.3.0  | 2026-10-17 | agent               | Added MCP7940_Async non-blocking operation queue
+1.3.0  | 2026-10-16 | agent               | Added MCP7940_EventLog SRAM ring buffer class
+1.3.0  | 2026-10-16 | agent               | Added readRAMBlock()/writeRAMBlock(), chunked to the I2C buffer size
+1.3.0  | 2026-10-16 | agent               | constexpr DateTime and TimeSpan, added MCP7940_BUILD_TIME
+1.3.0  | 2026-10-16 | agent               | Loop-free civil-from-days in DateTime(uint32_t)
+1.3.0  | 2026-10-17 | agent               | Table-driven O(1) date2days() and DateTime(unixtime) conversions
+1.3.0  | 2026-10-17 | agent               | Added cached clock mode to now()
+1.3.0  | 2026-10-17 | agent               | Added optional per-method I2C instrumentation counters
+1.3.0  | 2026-10-17 | agent               | setAlarm() writes the alarm in one burst, skips needless deviceStart()
+1.3.0  | 2026-10-16 | agent               | Burst reads in getAlarm(), added getAlarms() and getPowerFailTimes()
+1.3.0  | 2026-10-17 | agent               | Added optional write-through cache of the CONTROL and OSCTRIM registers
+1.3.0  | 2026-10-17 | agent               | Added burst mode to adjust(), about 5 transactions instead of 24
 1.2.2  | 2025-01-26 | Hady-sarhan         | Issue #66 - Corrected setting Wire.begin
 1.2.2  | 2023-06-12 | Mark-Wills          | Issue #65 - Corrected return value
 1.2.2  | 2021-12-16 | BrotherV            | Issue #63 - Add ESP8266 support for defining SDA and SCL pins.
@@ -156,6 +180,7 @@ const uint8_t  MCP7940_PWRUPHOUR{0x1D};        ///< Power-Fail, PWRUPHOUR Regist
 const uint8_t  MCP7940_PWRUPDATE{0x1E};        ///< Power-Fail, PWRUPDATE Register address
 const uint8_t  MCP7940_PWRUPMTH{0x1F};         ///< Power-Fail, PWRUPMTH Register address
 const uint8_t  MCP7940_RAM_ADDRESS{0x20};      ///< NVRAM - Start address for SRAM
+const uint8_t  MCP7940_RAM_SIZE{64};           ///< NVRAM - Size of the SRAM in bytes
 const uint8_t  MCP7940_EUI_RAM_ADDRESS{0xF0};  ///< EUI - Start address for protected EEPROM
 const uint8_t  MCP7940_ST{7};                  ///< MCP7940 register bits. RTCSEC reg
 const uint8_t  MCP7940_12_24{6};               ///< RTCHOUR, PWRDNHOUR & PWRUPHOUR
@@ -177,47 +202,130 @@ const uint8_t  MCP7940_ALMPOL{7};              ///< ALM0WKDAY register
 const uint8_t  MCP7940_ALM0IF{3};              ///< ALM0WKDAY register
 const uint8_t  MCP7940_ALM1IF{3};              ///< ALM1WKDAY register
 const uint32_t SECS_1970_TO_2000{946684800};   ///< Seconds between year 1970 and 2000
+const uint8_t  MCP7940_CACHE_SIZE{2};          ///< Number of registers in the shadow cache
+const uint8_t  MCP7940_SNAPSHOT_SIZE{0x20};    ///< Registers 0x00-0x1F held by MCP7940_Snapshot
+const uint8_t  MCP7940_ERROR_NONE{0};          ///< Bus error, none since last getLastError()
+const uint8_t  MCP7940_ERROR_NACK{1};          ///< Bus error, write not acknowledged or bus fault
+const uint8_t  MCP7940_ERROR_SHORT_READ{2};    ///< Bus error, fewer bytes received than requested
+const uint8_t  MCP7940_ERROR_DEADLINE{3};      ///< Bus error, retries stopped by the call deadline
+const uint16_t MCP7940_TIMEBASE_WINDOW{3600};  ///< Seconds per MCP7940_Timebase drift window
+const uint8_t  MCP7940_SCHEDULER_SIZE{16};     ///< Virtual alarms held by MCP7940_Scheduler
+const uint8_t  MCP7940_CALIBRATION_MIN{4};     ///< Samples needed before the trim is changed
+const uint16_t MCP7940_CALIBRATION_OUTLIER{2000};  ///< ms residual beyond which a sample is ignored
+const float    MCP7940_CALIBRATION_ERROR{1.0};     ///< Largest ppm standard error to change trim
+const uint8_t  MCP7940_ASYNC_QUEUE{4};         ///< Operations held by MCP7940_Async
+const uint8_t  MCP7940_ASYNC_TIMEOUT{255};     ///< ms to wait for OSCRUN, as in deviceStart()
+const uint8_t  MCP7940_ASYNC_UNKNOWN{0};       ///< Async status, handle unknown or overwritten
+const uint8_t  MCP7940_ASYNC_PENDING{1};       ///< Async status, queued or in progress
+const uint8_t  MCP7940_ASYNC_DONE{2};          ///< Async status, completed successfully
+const uint8_t  MCP7940_ASYNC_FAILED{3};        ///< Async status, I2C error or oscillator timeout
+
+/***************************************************************************************************
+** Optional per-method I2C instrumentation. The library and the sketch must be compiled with the  **
+** same setting, so either un-comment the following line or add "-DMCP7940_INSTRUMENTATION" to    **
+** the build flags. When not defined none of the instrumentation code or data is compiled in.     **
+** When defined the counters are allocated on the heap on first use.                              **
+***************************************************************************************************/
+// #define MCP7940_INSTRUMENTATION
+const uint8_t MCP7940_API_NONE{255};  ///< _currentApi value when no method is being measured
+struct MCP7940_ApiStatistics {
+  /*!
+   @struct  MCP7940_ApiStatistics
+   @brief   Cumulative I2C traffic caused by one public method, including all nested calls
+  */
+  uint32_t calls{0};         ///< Number of calls from outside the library
+  uint32_t transactions{0};  ///< Write and read transactions, an addressed read counts as 2
+  uint32_t bytes{0};         ///< Bytes moved, excluding the I2C address bytes
+  uint16_t failures{0};      ///< Transactions with a non-zero endTransmission() or a short read
+  uint32_t micros{0};        ///< Cumulative time spent in the method in microseconds
+};  // of struct MCP7940_ApiStatistics
+  #ifdef MCP7940_INSTRUMENTATION
+    /** @brief Public methods with their own statistics, overloaded methods share one entry */
+    #define MCP7940_API_LIST(X)                                                                    \
+      X(begin) X(deviceStatus) X(deviceStart) X(deviceStop) X(now) X(adjust) X(adjustAtMicros)     \
+      X(adjustOnEdge) X(calibrate) X(getCalibrationTrim) X(weekdayRead) X(weekdayWrite)            \
+      X(setMFP) X(getMFP) X(setAlarm) X(setAlarmPolarity) X(getAlarm) X(getAlarms) X(clearAlarm)   \
+      X(setAlarmState) X(getAlarmState) X(isAlarm) X(getSQWSpeed) X(setSQWSpeed) X(setSQWState)    \
+      X(getSQWState) X(setBattery) X(getBattery) X(getPowerFail) X(clearPowerFail)                 \
+      X(getPowerDown) X(getPowerUp) X(getPowerFailTimes) X(readSnapshot) X(calibrateOrAdjust)      \
+      X(getPPMDeviation) X(refreshCache) X(readRAM) X(writeRAM) X(readRAMBlock) X(writeRAMBlock)   \
+      X(readEUI) X(writeEUI)
+    /** @brief Expand a MCP7940_API_LIST entry to an enumeration value */
+    #define MCP7940_API_ENUM(name) MCP7940_API_##name,
+enum MCP7940_Api : uint8_t {
+  MCP7940_API_LIST(MCP7940_API_ENUM) MCP7940_API_COUNT  ///< Number of instrumented methods
+};  // of enum MCP7940_Api
+    #undef MCP7940_API_ENUM
+    /** @brief Attribute the I2C traffic of the current method to the named API */
+    #define MCP7940_INSTRUMENT(name) const ApiScope apiScope(*this, MCP7940_API_##name)
+    /** @brief Record one transaction of "bytes" bytes with its failure status */
+    #define MCP7940_RECORD(bytes, failed) recordTransaction(bytes, failed)
+/** @brief Names of the instrumented methods as consecutive zero-terminated strings */
+extern const char MCP7940_API_NAMES[] PROGMEM;
+  #else
+    #define MCP7940_INSTRUMENT(name)       ///< Instrumentation compiled out
+    #define MCP7940_RECORD(bytes, failed)  ///< Instrumentation compiled out
+  #endif
 
 class DateTime {
   /*!
     @class   DateTime
     @brief   Simple general-purpose date/time class
     @details Copied from RTClib. For further information on this implementation see
-             https://github.com/Zanduino/MCP7940/wiki/DateTimeClass
+             https://github.com/Zanduino/MCP7940/wiki/DateTimeClass \n
+             All constructors except the __FlashStringHelper one, the accessors, unixtime(),
+             secondstime(), dayOfTheWeek() and the operators are "constexpr", so that date/time
+             values and tables of them can be computed by the compiler. On the AVR a constant
+             table is still copied to RAM at start-up unless it is declared PROGMEM, and the
+             entries of a PROGMEM table have to be read with memcpy_P(), for example
+             "DateTime dt; memcpy_P(&dt, &table[i], sizeof(dt));".
   */
  public:
-  DateTime(uint32_t t = SECS_1970_TO_2000);
-  DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0,
-           uint8_t sec = 0);
-  DateTime(const DateTime& copy);
-  DateTime(const char* date, const char* time);
+  constexpr DateTime(uint32_t t = SECS_1970_TO_2000)
+      : DateTime(decode(t < SECS_1970_TO_2000 ? 0 : t - SECS_1970_TO_2000)) {}
+  constexpr DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0,
+                     uint8_t sec = 0)
+      : yOff(year >= 2000 ? year - 2000 : year), m(month), d(day), hh(hour), mm(min), ss(sec) {}
+  constexpr DateTime(const DateTime& copy) = default;
+  constexpr DateTime(const char* date, const char* time)
+      : yOff(conv2d(date + 9)),
+        m(monthFromName(date)),
+        d(conv2d(date + 4)),
+        hh(conv2d(time)),
+        mm(conv2d(time + 3)),
+        ss(conv2d(time + 6)) {}
   DateTime(const __FlashStringHelper* date, const __FlashStringHelper* time);
-  uint16_t year() const { /*! return the current year */
+  constexpr uint16_t year() const { /*! return the current year */
     return 2000U + yOff;
   }
-  uint8_t month() const { /*! return the current month */
+  constexpr uint8_t month() const { /*! return the current month */
     return m;
   }
-  uint8_t day() const { /*! return the current day of the month */
+  constexpr uint8_t day() const { /*! return the current day of the month */
     return d;
   }
-  uint8_t hour() const { /*! return the current hour */
+  constexpr uint8_t hour() const { /*! return the current hour */
     return hh;
   }
-  uint8_t minute() const { /*! return the current minute */
+  constexpr uint8_t minute() const { /*! return the current minute */
     return mm;
   }
-  uint8_t second() const { /*! return the current second */
+  constexpr uint8_t second() const { /*! return the current second */
     return ss;
   }
-  uint8_t  dayOfTheWeek() const;            /*! return the current day of the week starting at 0 */
-  long     secondstime() const;             /*! return the current seconds in the year */
-  uint32_t unixtime(void) const;            /*! return the current Unixtime */
-  bool     equals(const DateTime* other);   /*! return true if two datetimes hold the same value */
-  DateTime operator+(const TimeSpan& span); /*! Overloaded "+" operator to add two timespans */
-  DateTime operator-(const TimeSpan& span); /*! Overloaded "+" operator to add two timespans */
-  TimeSpan operator-(
-      const DateTime& right); /*! Overloaded "-" operator subtract add two timespans */
+  constexpr uint8_t dayOfTheWeek() const { /*! return the current day of the week, Monday is 1 */
+    return (date2days(yOff, m, d) + 5) % 7 + 1;  // Jan 1, 2000 is a Saturday, i.e. 6
+  }
+  constexpr long secondstime() const { /*! return the time in seconds since the year 2000 */
+    return time2long(date2days(yOff, m, d), hh, mm, ss);
+  }
+  constexpr uint32_t unixtime() const { /*! return the current Unixtime */
+    return time2long(date2days(yOff, m, d), hh, mm, ss) + SECS_1970_TO_2000;
+  }
+  bool equals(const DateTime* other); /*! return true if two datetimes hold the same value */
+  constexpr DateTime operator+(const TimeSpan& span) const; /*! Add a timespan */
+  constexpr DateTime operator-(const TimeSpan& span) const; /*! Subtract a timespan */
+  constexpr TimeSpan operator-(const DateTime& right) const; /*! Difference of two datetimes */
  protected:
   uint8_t yOff;  ///< Internal year offset value
   uint8_t m;     ///< Internal month value
@@ -225,7 +333,72 @@ class DateTime {
   uint8_t hh;    ///< Internal hour value
   uint8_t mm;    ///< Internal minute value
   uint8_t ss;    ///< Internal seconds
-};               // of class DateTime definition
+
+ private:
+  /*************************************************************************************************
+  ** The conversions are written as single-expression C++11 constexpr functions. Intermediate     **
+  ** values are passed down as parameters so that nothing is computed twice at runtime           **
+  *************************************************************************************************/
+  static constexpr uint16_t leapDaysBefore(const uint8_t y) { /*! leap days before year 2000+y */
+    return (y + 3) / 4 - (y + 99) / 100 + (y + 399) / 400;
+  }
+  static constexpr uint8_t isLeapYear(const uint8_t y) { /*! 1 if 2000+y is a leap year */
+    return leapDaysBefore(y + 1) - leapDaysBefore(y);
+  }
+  static constexpr uint16_t date2days(const uint8_t y, const uint8_t m, const uint8_t d) {
+    /*! days since 2000-01-01, (367m-362)/12 is the days before month m with 30 day February */
+    return 365U * y + leapDaysBefore(y) + (367 * m - 362) / 12 - (m > 2 ? 2 - isLeapYear(y) : 0) +
+           d - 1;
+  }
+  static constexpr uint32_t time2long(const uint16_t days, const uint8_t h, const uint8_t m,
+                                      const uint8_t s) { /*! seconds for a D H M S value */
+    return ((days * 24UL + h) * 60 + m) * 60 + s;
+  }
+  static constexpr uint8_t conv2d(const char* p) { /*! convert 2 digits, leading space is 0 */
+    return 10 * ('0' <= p[0] && p[0] <= '9' ? p[0] - '0' : 0) + p[1] - '0';
+  }
+  static constexpr uint8_t monthFromName(const char* date) { /*! month from "MMM DD YYYY" */
+    return date[0] == 'J'   ? (date[1] == 'a' ? 1 : (date[2] == 'n' ? 6 : 7))  // Jan June July
+           : date[0] == 'F' ? 2                                                // February
+           : date[0] == 'A' ? (date[2] == 'r' ? 4 : 8)                         // April August
+           : date[0] == 'M' ? (date[2] == 'r' ? 3 : 5)                         // March May
+           : date[0] == 'S' ? 9                                                // September
+           : date[0] == 'O' ? 10                                               // October
+           : date[0] == 'N' ? 11                                               // November
+           : date[0] == 'D' ? 12                                               // December
+                            : 0;
+  }
+  /*************************************************************************************************
+  ** H. Hinnant's civil-from-days algorithm on March-based years, so that the leap day is the last **
+  ** day of the year and the month follows from the day of the year with a linear formula. All   **
+  ** values fit in 16 bits and there are no loops or tables. January and February 2000 belong to  **
+  ** the March-based year 1999 and are counted from 1996-03-01, one 4 year cycle earlier          **
+  *************************************************************************************************/
+  static constexpr DateTime decode(const uint32_t s) { /*! split seconds since 2000 */
+    return decodeDays(s / 86400, s % 86400);
+  }
+  static constexpr DateTime decodeDays(const uint16_t days, const uint32_t tod) {
+    /*! day of the era since 2000-03-01, or since 1996-03-01 for January and February 2000 */
+    return decodeEra(days < 60, days < 60 ? days + 1401 : days - 60, tod);
+  }
+  static constexpr DateTime decodeEra(const bool early, const uint16_t doe, const uint32_t tod) {
+    /*! March-based year of the era */
+    return decodeYear(early, (doe - doe / 1460 + doe / 36524) / 365, doe, tod);
+  }
+  static constexpr DateTime decodeYear(const bool early, const uint16_t yoe, const uint16_t doe,
+                                       const uint32_t tod) { /*! day of the year, 0 is Mar 1 */
+    return decodeMonth(early, yoe, doe - (365 * yoe + yoe / 4 - yoe / 100), tod);
+  }
+  static constexpr DateTime decodeMonth(const bool early, const uint16_t yoe, const uint16_t doy,
+                                        const uint32_t tod) { /*! month, 0 is March */
+    return decodeFields(early, yoe, doy, (5 * doy + 2) / 153, tod);
+  }
+  static constexpr DateTime decodeFields(const bool early, const uint16_t yoe, const uint16_t doy,
+                                         const uint16_t mp, const uint32_t tod) { /*! fields */
+    return DateTime(yoe + (mp >= 10) - (early ? 4 : 0), mp < 10 ? mp + 3 : mp - 9,
+                    doy - (153 * mp + 2) / 5 + 1, tod / 3600, tod / 60 % 60, tod % 60);
+  }
+};  // of class DateTime definition
 class TimeSpan {
   /*!
    @class   TimeSpan
@@ -234,28 +407,221 @@ class TimeSpan {
             https://github.com/Zanduino/MCP7940/wiki/TimeSpanClass for additional details
   */
  public:
-  TimeSpan(int32_t seconds = 0);                                         ///< Default constructor
-  TimeSpan(int16_t days, int8_t hours, int8_t minutes, int8_t seconds);  ///< Overloaded constructor
-  TimeSpan(const TimeSpan& copy);                                        ///< Overloaded constructor
-  int16_t  days() const { return _seconds / 86400L; }      ///< return the number of days
-  int8_t   hours() const { return _seconds / 3600 % 24; }  ///< return number of hours
-  int8_t   minutes() const { return _seconds / 60 % 60; }  ///< return number of minutes
-  int8_t   seconds() const { return _seconds % 60; }       ///< return number of seconds
-  int32_t  totalseconds() const { return _seconds; }       ///< return total number of seconds
-  TimeSpan operator+(const TimeSpan& right);               ///< redefine "+" operator
-  TimeSpan operator-(const TimeSpan& right);               ///< redefine "-" operator
+  constexpr TimeSpan(int32_t seconds = 0) : _seconds(seconds) {}  ///< Default constructor
+  constexpr TimeSpan(int16_t days, int8_t hours, int8_t minutes, int8_t seconds)
+      : _seconds((int32_t)days * 86400L + (int32_t)hours * 3600 + (int32_t)minutes * 60 +
+                 seconds) {}                                            ///< Overloaded constructor
+  constexpr TimeSpan(const TimeSpan& copy) = default;                   ///< Overloaded constructor
+  constexpr int16_t days() const { return _seconds / 86400L; }          ///< return number of days
+  constexpr int8_t  hours() const { return _seconds / 3600 % 24; }      ///< return number of hours
+  constexpr int8_t  minutes() const { return _seconds / 60 % 60; }      ///< return number of minutes
+  constexpr int8_t  seconds() const { return _seconds % 60; }           ///< return number of seconds
+  constexpr int32_t totalseconds() const { return _seconds; }          ///< return total seconds
+  constexpr TimeSpan operator+(const TimeSpan& right) const {          ///< redefine "+" operator
+    return TimeSpan(_seconds + right._seconds);
+  }
+  constexpr TimeSpan operator-(const TimeSpan& right) const {  ///< redefine "-" operator
+    return TimeSpan(_seconds - right._seconds);
+  }
+
  protected:
   int32_t _seconds;  ///< Internal value for total seconds
 };                   // of class TimeSpan definition
+constexpr DateTime DateTime::operator+(const TimeSpan& span) const {
+  /*! Overloaded "+" operator, returns the DateTime plus the TimeSpan */
+  return DateTime(unixtime() + span.totalseconds());
+}  // of overloaded + function
+constexpr DateTime DateTime::operator-(const TimeSpan& span) const {
+  /*! Overloaded "-" operator, returns the DateTime minus the TimeSpan */
+  return DateTime(unixtime() - span.totalseconds());
+}  // of overloaded - function
+constexpr TimeSpan DateTime::operator-(const DateTime& right) const {
+  /*! Overloaded "-" operator, returns the difference of two DateTime values */
+  return TimeSpan(unixtime() - right.unixtime());
+}  // of overloaded - function
+/** @brief Date and time at which the source file including this header was compiled */
+constexpr DateTime MCP7940_BUILD_TIME(__DATE__, __TIME__);
+static_assert(DateTime(2099, 12, 31, 23, 59, 59).unixtime() == 4102444799UL &&
+                  DateTime(2099, 12, 31).dayOfTheWeek() == 4 &&
+                  DateTime(4102444799UL).year() == 2099 && DateTime(4102444799UL).day() == 31,
+              "DateTime arithmetic overflows for the last supported date");
+
+class MCP7940_WireTransport {
+  /*!
+   @class   MCP7940_WireTransport
+   @brief   Default transport, performs the library's I2C traffic with an Arduino TwoWire object
+   @details A transport is any class with the five inline methods below. The library calls them
+            on a concrete type selected at compile time, so there is no vtable or function pointer
+            and the calls are inlined just like direct Wire calls. A write never has more than
+            BUFFER_LENGTH-1 data bytes and a read never more than BUFFER_LENGTH bytes. Every
+            method must return within the time set with setTimeout(), if the bus supports it.\n
+            To use another bus driver, e.g. the ESP-IDF i2c driver, a software I2C or a host mock,
+            write a class with these methods, include "MCP7940_Impl.h" and declare the device as
+            MCP7940_Base<ClassName>. Devices on different transports can be used in one program
+  */
+ public:
+  MCP7940_WireTransport(TwoWire& wire = Wire) : _wire(&wire) {}  ///< Use the given bus
+  void begin(const uint8_t sda, const uint8_t scl, const uint32_t clockHz) const {
+    /*!
+     @brief     Start the bus as master
+     @param[in] sda     SDA pin, only used on ESP8266
+     @param[in] scl     SCL pin, only used on ESP8266
+     @param[in] clockHz Bus speed in Herz
+    */
+  #if defined(ESP8266)
+    _wire->begin(sda, scl);  // Start I2C as master device using the specified SDA and SCL
+  #else
+    _wire->begin();  // Start I2C as master device
+  #endif
+    (void)sda;                // force compiler to ignore this potentially unused parameter
+    (void)scl;                // force compiler to ignore this potentially unused parameter
+    _wire->setClock(clockHz);  // Set the I2C bus speed
+  }  // of method begin()
+  void setTimeout(const uint32_t timeoutMicros) const {
+    /*!
+     @brief     Limit how long a single transaction may block, e.g. on a stuck bus
+     @details   Uses the Wire timeout of the AVR and megaAVR cores and of the ESP32, other Wire
+                libraries don't have one and the call is ignored
+     @param[in] timeoutMicros Timeout in microseconds, 0 turns the timeout off
+    */
+  #if defined(WIRE_HAS_TIMEOUT)
+    _wire->setWireTimeout(timeoutMicros, true);  // Reset the bus hardware on a timeout
+  #elif defined(ESP32)
+    _wire->setTimeOut((timeoutMicros + 999) / 1000);  // ESP32 timeout is in milliseconds
+  #else
+    (void)timeoutMicros;  // No timeout support
+  #endif
+  }  // of method setTimeout()
+  uint8_t probe(const uint8_t device) const {
+    /*!
+     @brief     Address a device without sending data
+     @param[in] device I2C address
+     @return    0 if the device acknowledged, otherwise an error code
+    */
+    _wire->beginTransmission(device);
+    return _wire->endTransmission();
+  }  // of method probe()
+  uint8_t write(const uint8_t device, const uint8_t reg, const uint8_t* data,
+                const uint8_t len) const {
+    /*!
+     @brief     Burst write of consecutive registers
+     @param[in] device I2C address
+     @param[in] reg    First register address
+     @param[in] data   Bytes to write
+     @param[in] len    Number of bytes to write
+     @return    0 on success, otherwise an error code
+    */
+    _wire->beginTransmission(device);  // Address the I2C device
+    _wire->write(reg);                 // Send register address to write to
+    _wire->write(data, len);           // write the data
+    return _wire->endTransmission();   // close transmission and return status
+  }  // of method write()
+  uint8_t writeRead(const uint8_t device, const uint8_t reg, uint8_t* data,
+                    const uint8_t len) const {
+    /*!
+     @brief      Write a register address, then read consecutive registers
+     @param[in]  device I2C address
+     @param[in]  reg    First register address
+     @param[out] data   Buffer for the bytes read
+     @param[in]  len    Number of bytes to read
+     @return     Number of bytes read, 0 if the register address wasn't acknowledged
+    */
+    _wire->beginTransmission(device);             // Address the I2C device
+    _wire->write(reg);                            // Send register address to read from
+    if (_wire->endTransmission() != 0) return 0;  // Stop on error
+    const uint8_t received = _wire->requestFrom(device, len);  // Request a block of data
+    for (uint8_t i = 0; i < received; ++i) data[i] = _wire->read();  // Copy to buffer
+    return received;
+  }  // of method writeRead()
+
+ private:
+  TwoWire* _wire;  ///< I2C bus the device is connected to, a pointer so devices can be copied
+};  // of class MCP7940_WireTransport
+struct MCP7940_Alarm {
+  /*!
+   @struct  MCP7940_Alarm
+   @brief   Settings of one alarm as returned by MCP7940_Class::getAlarms()
+  */
+  DateTime dateTime;      ///< Alarm date/time, the year is not stored and is set to 0
+  uint8_t  alarmType{0};  ///< Alarm type 0-7 from the ALMxMSK bits
+  bool     interrupt{false};  ///< ALMxIF flag, true if the alarm has been triggered
+};  // of struct MCP7940_Alarm
+class MCP7940_Codec {
+  /*!
+   @class   MCP7940_Codec
+   @brief   Conversions between DateTime values and register contents, independent of the bus
+   @details Base class of MCP7940_Base, so the code is shared by the instantiations for all
+            transports and is also used by MCP7940_Snapshot. The helpers are static and public so
+            that register images can be converted without a device, e.g. by the host benchmark
+  */
+ public:
+  static void     decodeTimes(const uint8_t* blocks, DateTime* dates, const uint16_t count);
+  static uint8_t  bcd2int(const uint8_t bcd);  // convert BCD digits to integer
+  static uint8_t  int2bcd(const uint8_t dec);  // convert integer to BCD
+  static void     encodeTime(const DateTime& dt, const uint8_t wkday,
+                             uint8_t* block);  // build RTCSEC to RTCYEAR block
+  static DateTime decodeTime(const uint8_t* block);  // decode RTCSEC to RTCYEAR block
+  static DateTime decodeAlarm(const uint8_t* block, uint8_t& alarmType);  // decode ALMx block
+  static DateTime decodePowerFail(const uint8_t* block);  // decode PWRDN or PWRUP block
+  static int8_t   calibrationTrim(int16_t trim, const uint8_t speed,
+                                  const float fMeas);  // Trim from a frequency
+  static int8_t   calibrationTrim(int16_t trim, const uint8_t speed, const uint32_t counts,
+                                  const uint32_t gateMicros);  // Trim from counts in a gate time
+};  // of class MCP7940_Codec
+class MCP7940_Snapshot {
+  /*!
+   @class   MCP7940_Snapshot
+   @brief   Copy of all timekeeping, alarm and power-fail registers, filled by readSnapshot()
+   @details The accessors decode the copy in memory and return the same values as the
+            MCP7940_Class methods of the same name would have returned when the snapshot was read
+  */
+ public:
+  bool     valid() const { return _valid; }  ///< true if the last readSnapshot() succeeded
+  uint8_t  getRegister(const uint8_t reg) const;
+  DateTime now() const;
+  bool     deviceStatus() const;
+  uint8_t  weekdayRead() const;
+  int8_t   getCalibrationTrim() const;
+  uint8_t  getMFP() const;
+  DateTime getAlarm(const uint8_t alarmNumber, uint8_t& alarmType) const;
+  bool     getAlarmState(const uint8_t alarmNumber) const;
+  bool     isAlarm(const uint8_t alarmNumber) const;
+  uint8_t  getSQWSpeed() const;
+  bool     getSQWState() const;
+  bool     getBattery() const;
+  bool     getPowerFail() const;
+  DateTime getPowerDown() const;
+  DateTime getPowerUp() const;
+
+ private:
+  template <class> friend class MCP7940_Base;           // Fills the registers
+  uint8_t _registers[MCP7940_SNAPSHOT_SIZE]{};           ///< Registers 0x00-0x1F
+  bool    _valid{false};                                 ///< Registers were read successfully
+  bool    bit(const uint8_t reg, const uint8_t b) const;  // Read one register bit
+};  // of class MCP7940_Snapshot
+/** @brief Callback of MCP7940_Scheduler, called with the id of the virtual alarm which fired */
+typedef void (*MCP7940_EventCallback)(const uint8_t id);
+/** @brief Completion callback of MCP7940_Async, called with the handle and the final status */
+typedef void (*MCP7940_AsyncCallback)(const uint8_t handle, const uint8_t status);
 
-class MCP7940_Class {
+template <class Transport>
+class MCP7940_Base : public MCP7940_Codec {
   /*!
-   @class MCP7940_Class
+   @class MCP7940_Base
    @brief Main class definition with forward declarations
+   @details All bus traffic goes through the Transport class, see MCP7940_WireTransport, whose
+            methods are called directly and inlined. MCP7940_Class is the instantiation for the
+            default transport; each instance uses the I2C bus passed to the constructor, "Wire" by
+            default, so that devices on "Wire" and "Wire1" can be used at the same time
   */
  public:
-  MCP7940_Class(){};   ///< Unused Class constructor
-  ~MCP7940_Class(){};  ///< Unused Class destructor
+  explicit MCP7940_Base(const Transport& bus = Transport())
+      : _bus(bus){};  ///< Class constructor, sets the bus, e.g. "Wire1"
+  #ifdef MCP7940_INSTRUMENTATION
+  ~MCP7940_Base() { delete[] _apiStatistics; }  ///< Frees the instrumentation counters
+  MCP7940_Base(const MCP7940_Base&) = delete;             ///< Counters are owned, no copies
+  MCP7940_Base& operator=(const MCP7940_Base&) = delete;  ///< Counters are owned, no copies
+  #endif
   bool     begin(const uint32_t i2cSpeed) const;
   bool     begin(const uint8_t sda = SDA, const uint8_t scl = SCL,
                  const uint32_t i2cSpeed = I2C_STANDARD_MODE) const;
@@ -263,26 +629,37 @@ class MCP7940_Class {
   bool     deviceStart() const;
   bool     deviceStop() const;
   DateTime now() const;
+  bool     now(DateTime& dt) const;
   void     adjust();
-  void     adjust(const DateTime& dt);
+  void     adjust(const DateTime& dt, const bool burst = false);
+  bool     adjustAtMicros(const DateTime& dt, const uint32_t atMicros, uint32_t& latency);
+  bool     adjustOnEdge(const DateTime& dt, const uint8_t pin, uint32_t& latency,
+                        const uint16_t timeoutMs = 2000);
   int8_t   calibrate() const;
   int8_t   calibrate(const int8_t newTrim);
   int8_t   calibrate(const DateTime& dt);
-  int8_t   calibrate(const float fMeas) const;
+  int8_t   calibrate(const float fMeas);
+  int8_t   calibrate(const uint32_t counts, const uint32_t gateMicros);
   int8_t   getCalibrationTrim() const;
+  bool     getCalibrationTrim(int8_t& trim) const;
   uint8_t  weekdayRead() const;
+  bool     weekdayRead(uint8_t& dow) const;
   uint8_t  weekdayWrite(const uint8_t dow) const;
   bool     setMFP(const bool value) const;
   uint8_t  getMFP() const;
+  bool     getMFP(uint8_t& mode) const;
   bool     setAlarm(const uint8_t alarmNumber, const uint8_t alarmType, const DateTime& dt,
                     const bool state = true) const;
   void     setAlarmPolarity(const bool polarity) const;
   DateTime getAlarm(const uint8_t alarmNumber, uint8_t& alarmType) const;
+  bool     getAlarm(const uint8_t alarmNumber, DateTime& dt, uint8_t& alarmType) const;
+  bool     getAlarms(MCP7940_Alarm alarms[2]) const;
   bool     clearAlarm(const uint8_t alarmNumber) const;
   bool     setAlarmState(const uint8_t alarmNumber, const bool state) const;
   bool     getAlarmState(const uint8_t alarmNumber) const;
   bool     isAlarm(const uint8_t alarmNumber) const;
   uint8_t  getSQWSpeed() const;
+  bool     getSQWSpeed(uint8_t& frequency) const;
   bool     setSQWSpeed(uint8_t frequency, bool state = true) const;
   bool     setSQWState(const bool state) const;
   bool     getSQWState() const;
@@ -292,40 +669,63 @@ class MCP7940_Class {
   bool     clearPowerFail() const;
   DateTime getPowerDown() const;
   DateTime getPowerUp() const;
+  bool     getPowerFailTimes(DateTime& powerDown, DateTime& powerUp) const;
   int8_t   calibrateOrAdjust(const DateTime& dt);
   int32_t  getPPMDeviation(const DateTime& dt) const;
+  void     setRetryPolicy(const uint8_t retries, const uint32_t deadlineMicros = 0);
+  void     setBusTimeout(const uint32_t timeoutMicros) const;
+  uint8_t  getLastError() const;
+  uint32_t getRetryCount() const { return _retryCount; }  ///< Transactions repeated after an error
+  uint32_t getErrorCount() const { return _errorCount; }  ///< Transfers failed after all retries
   void     setSetUnixTime(uint32_t aTime);
   uint32_t getSetUnixTime() const;
+  void     setCache(const bool state);
+  bool     refreshCache() const;
+  void     invalidateCache() const;
+  void     setNowCache(const uint32_t resyncMillis);
+  void     clockTick() const;
+  uint32_t getNowStaleness() const;
+  bool     readSnapshot(MCP7940_Snapshot& snapshot) const;
+  uint8_t  readRAMBlock(const uint8_t addr, void* data, const uint8_t len) const;
+  uint8_t  writeRAMBlock(const uint8_t addr, const void* data, const uint8_t len) const;
+  #ifdef MCP7940_INSTRUMENTATION
+  void     dumpStatistics(Print& out) const;
+  void     resetStatistics() const;
+  const MCP7940_ApiStatistics& getStatistics(const MCP7940_Api api) const;
+  #endif
 
   /*************************************************************************************************
   ** Template functions definitions are done in the header file                                   **
   ** ============================================================================================ **
-  ** readRAM   read any number of bytes from the MCP7940 SRAM area                                **
-  ** writRAM   write any number of bytes to the MCP7940 SRAM area                                 **
+  ** readRAM   read up to 64 bytes from the MCP7940 SRAM area                                     **
+  ** writRAM   write up to 64 bytes to the MCP7940 SRAM area                                      **
   ** readEUI   read any number of bytes from the special protected SRAM area for 79400/401/402    **
   *************************************************************************************************/
   template <typename T>
   uint8_t readRAM(const uint8_t& addr, T& value) const {
     /*!
      @brief     Template for readRAM()
-     @details   As a template it can support compile-time data type definitions
+     @details   As a template it can support compile-time data type definitions. Types larger
+                than the I2C buffer are read in several transactions, see readRAMBlock()
      @param[in] addr Memory address
      @param[in] value    Data Type "T" to read
-     @return    Pointer to return data structure
+     @return    Number of bytes read
     */
-    return I2C_read((addr % 64) + MCP7940_RAM_ADDRESS, value);
+    MCP7940_INSTRUMENT(readRAM);
+    return readRAMBlock(addr, &value, sizeof(T));
   }  // of method readRAM()
   template <typename T>
   uint8_t writeRAM(const uint8_t& addr, const T& value) const {
     /*!
      @brief     Template for writeRAM()
-     @details   As a template it can support compile-time data type definitions
+     @details   As a template it can support compile-time data type definitions. Types larger
+                than the I2C buffer are written in several transactions, see writeRAMBlock()
      @param[in] addr Memory address
      @param[in] value Data Type "T" to write
-     @return    True if successful, otherwise false
+     @return    Number of bytes written
      */
-    uint8_t i = I2C_write((addr % 64) + MCP7940_RAM_ADDRESS, value);
-    return i;
+    MCP7940_INSTRUMENT(writeRAM);
+    return writeRAMBlock(addr, &value, sizeof(T));
   }  // of method writeRAM()
   template <typename T>
   uint8_t readEUI(const uint8_t& addr, T& value) const {
@@ -337,18 +737,10 @@ class MCP7940_Class {
      @param[in] value    Data Type "T" to read
      @return             Pointer to return data structure
     */
-    uint8_t i{0};                                        // return number of bytes read
-    Wire.beginTransmission(MCP7940_EUI_ADDRESS);         // Address the special I2C address
-    Wire.write((addr % 8) + MCP7940_EUI_RAM_ADDRESS);    // Send register address to read from
-    if (Wire.endTransmission() == 0) {                   // Close transmission and check error code
-      Wire.requestFrom(MCP7940_EUI_ADDRESS, sizeof(T));  // Request a block of data, max 61 bits
-      uint8_t* bytePtr = (uint8_t*)&value;               // Declare pointer to start of structure
-      for (i = 0; i < sizeof(T); i++) {                  // Loop for each byte to be read
-        *bytePtr++ = Wire.read();                        // Read a byte
-      }                                                  // of for-next each byte
-    }                                                    // if-then success
-    return i;                                            // return number of bytes read
-  }                                                      // of method readEUI()
+    MCP7940_INSTRUMENT(readEUI);
+    return busRead(MCP7940_EUI_ADDRESS, (addr % 8) + MCP7940_EUI_RAM_ADDRESS, (uint8_t*)&value,
+                   sizeof(T));  // Read from the protected area
+  }  // of method readEUI()
   template <typename T>
   uint8_t writeEUI(const uint8_t& addr, T& value) const {
     /*!
@@ -360,25 +752,52 @@ class MCP7940_Class {
      @param[in] value    Data Type "T" to read
      @return             Pointer to  data structure to write
     */
-    uint8_t i{0};                                      // return number of bytes read
-    Wire.beginTransmission(MCP7940_EUI_ADDRESS);       // Address the special I2C address
-    Wire.write(MCP7940_EEUNLOCK);                      // Send special register address to write to
-    Wire.write(0x55);                                  // Special write value to start unlock
-    i = Wire.endTransmission();                        // close transmission of first byte
-    Wire.beginTransmission(MCP7940_EUI_ADDRESS);       // Address the special I2C address
-    Wire.write(MCP7940_EEUNLOCK);                      // Send special register address to write to
-    Wire.write(0x55);                                  // Special write value to complete unlock
-    i = Wire.endTransmission();                        // close transmission of second byte
-    Wire.beginTransmission(MCP7940_EUI_ADDRESS);       // Address the special I2C address
-    Wire.write((addr % 8) + MCP7940_EUI_RAM_ADDRESS);  // Send register address to read from
-    Wire.write((uint8_t*)&value, sizeof(T));           // write the data
-    i = Wire.endTransmission();                        // close transmission of actual write
-    if (i == 0) i = sizeof(T);                         // return number of bytes on success
-    return i;                                          // return number of bytes read
-  }                                                    // of method writeEUI()
+    MCP7940_INSTRUMENT(writeEUI);
+    const uint8_t unlock = 0x55;                         // Special write value for the unlock
+    busWrite(MCP7940_EUI_ADDRESS, MCP7940_EEUNLOCK, &unlock, 1);  // Start the unlock sequence
+    busWrite(MCP7940_EUI_ADDRESS, MCP7940_EEUNLOCK, &unlock, 1);  // Complete the unlock sequence
+    uint8_t i = busWrite(MCP7940_EUI_ADDRESS, (addr % 8) + MCP7940_EUI_RAM_ADDRESS,
+                         (const uint8_t*)&value, sizeof(T));  // write the data
+    if (i == 0) i = sizeof(T);                          // return number of bytes on success
+    return i;                                           // return number of bytes read
+  }  // of method writeEUI()
 
  private:
-  uint32_t _SetUnixTime{0};  ///< UNIX time when clock last set
+  Transport         _bus;                          ///< Transport to the device's I2C bus
+  uint8_t           _retries{0};                   ///< Repeats of a failed transfer
+  uint32_t          _deadline{0};                  ///< Time limit for the repeats in us, 0 is none
+  mutable uint8_t   _lastError{MCP7940_ERROR_NONE};  ///< Last error since getLastError()
+  mutable uint32_t  _retryCount{0};                ///< Number of repeated transfers
+  mutable uint32_t  _errorCount{0};                ///< Number of failed transfers
+  uint32_t        _SetUnixTime{0};               ///< UNIX time when clock last set
+  bool            _cacheEnabled{false};          ///< Register shadow cache in use
+  mutable uint8_t _cacheValid{0};                ///< Bit mask of valid cache slots
+  mutable uint8_t _cache[MCP7940_CACHE_SIZE]{};  ///< Shadow copies of cached registers
+  uint32_t         _nowInterval{0};    ///< now() resync interval in ms, 0 if not cached
+  mutable uint32_t _nowTime{0};        ///< Cached clock, unixtime at the millis() anchor
+  mutable uint32_t _nowMillis{0};      ///< millis() value of the cached clock anchor
+  mutable uint32_t _nowLast{0};        ///< Last unixtime returned, keeps now() monotonic
+  mutable bool     _nowValid{false};   ///< Cached clock has been anchored
+  mutable bool     _nowPhase{false};   ///< Anchor is on a 1Hz edge, i.e. at the start of a second
+  #ifdef MCP7940_INSTRUMENTATION
+  class ApiScope {
+    /*!
+     @class   ApiScope
+     @brief   Attributes bus traffic and elapsed time to the outermost public method being called
+    */
+   public:
+    ApiScope(const MCP7940_Base& rtc, const MCP7940_Api api);
+    ~ApiScope();
+
+   private:
+    const MCP7940_Base& _rtc;         ///< Instrumented instance
+    bool                 _outermost;  ///< True if this scope owns the statistics entry
+    uint32_t             _start;      ///< micros() value when the method was entered
+  };  // of class ApiScope
+  void recordTransaction(const uint8_t bytes, const bool failed) const;  // Update counters
+  mutable MCP7940_ApiStatistics* _apiStatistics{nullptr};  ///< Per-method counters, on the heap
+  mutable uint8_t _currentApi{MCP7940_API_NONE};           ///< Method being measured
+  #endif
   /*************************************************************************************************
   ** Template functions definitions are done in the header file                                   **
   ** ============================================================================================ **
@@ -398,16 +817,8 @@ class MCP7940_Class {
     @param[in] value   Data Type "T" to read
     @return    number of bytes read
    */
-    uint8_t i{0};                                    // return number of bytes read
-    Wire.beginTransmission(MCP7940_ADDRESS);         // Address the I2C device
-    Wire.write(address);                             // Send register address to read from
-    if (Wire.endTransmission() == 0) {               // Close transmission and check error code
-      Wire.requestFrom(MCP7940_ADDRESS, sizeof(T));  // Request a block of data
-      uint8_t* bytePtr = (uint8_t*)&value;           // Declare pointer to start of structure
-      for (i = 0; i < sizeof(T); i++) {              // Loop for each byte to be read
-        *bytePtr++ = Wire.read();                    // Read a byte
-      }                                              // of for-next each byte
-    }                                                // if-then success
+    const uint8_t i = busRead(MCP7940_ADDRESS, address, (uint8_t*)&value, sizeof(T));
+    if (i == sizeof(T) && _cacheEnabled) cacheUpdate(address, (uint8_t*)&value, i);  // Refresh
     return i;                                        // return number of bytes read
   }                                                  // end of template method "I2C_read"
   template <typename T>
@@ -421,20 +832,342 @@ class MCP7940_Class {
       @param[in] value   Data Type "T" to write
       @return    number of bytes written
      */
-    Wire.beginTransmission(MCP7940_ADDRESS);   // Address the I2C device
-    Wire.write(address);                       // Send register address to read from
-    Wire.write((uint8_t*)&value, sizeof(T));   // write the data
-    uint8_t i = Wire.endTransmission();        // close transmission and save status
-    if (i == 0) i = sizeof(T);                 // return number of bytes on success
+    uint8_t i = busWrite(MCP7940_ADDRESS, address, (const uint8_t*)&value, sizeof(T));
+    if (i == 0) {                              // on success
+      i = sizeof(T);                           // return number of bytes
+      if (_cacheEnabled) cacheUpdate(address, (uint8_t*)&value, i);  // Write-through to cache
+    }                                                                // if-then success
     return i;                                  // return the number of bytes written
   }                                            // end of template method "I2C_write()"
+  template <class> friend class MCP7940_AsyncBase;       // Runs the adjust() steps one at a time
+  template <class> friend class MCP7940_SchedulerBase;   // Re-arms the alarms with one write
+  template <class> friend class MCP7940_CalibratorBase;  // Reads the device, bypassing the cache
+  template <class> friend class MCP7940_PowerLogBase;    // Clears PWRFAIL from a snapshot
+  template <class> friend class MCP7940_TimebaseBase;    // Reads the device, bypassing the cache
+  void    adjusted(const DateTime& dt, const bool onEdge = false);  // Record a new clock setting
+  bool    adjustPrepare(const DateTime& dt, uint8_t* block);  // Stop the clock, build the write
+  bool    adjustFinish(const DateTime& dt, const uint8_t* block, const uint32_t reference,
+                       uint32_t& latency);  // Send the pre-built time write
+  uint8_t busRead(const uint8_t device, const uint8_t reg, uint8_t* data,
+                  const uint8_t len) const;  // Read with retries
+  uint8_t busWrite(const uint8_t device, const uint8_t reg, const uint8_t* data,
+                   const uint8_t len) const;  // Write with retries
+  bool    busRetry(const uint8_t error, uint8_t& attempt,
+                   const uint32_t start) const;  // Decide on another attempt
   uint8_t readByte(const uint8_t addr) const;  // Read 1 byte from address on I2C
-  uint8_t bcd2int(const uint8_t bcd) const;    // convert BCD digits to integer
-  uint8_t int2bcd(const uint8_t dec) const;    // convert integer to BCD
+  bool    readNow(DateTime& dt) const;         // Read the date/time from the device
+  bool    writeAlarm(const uint8_t alarmNumber, const uint8_t alarmType, const DateTime& dt,
+                     const bool state) const;  // Write an alarm, the oscillator is running
+  uint8_t readCached(const uint8_t reg) const;  // Read 1 byte from cache or I2C
+  void    cacheUpdate(const uint8_t address, const uint8_t* data,
+                      const uint8_t len) const;  // Update shadow cache after a transfer
+  static uint8_t cacheSlot(const uint8_t reg);   // Shadow cache slot for a register
   void    clearRegisterBit(const uint8_t reg, const uint8_t b) const;  // Clear a bit, values 0-7
   void    setRegisterBit(const uint8_t reg, const uint8_t b) const;    // Set   a bit, values 0-7
   void    writeRegisterBit(const uint8_t reg, const uint8_t b,
                            bool bitvalue) const;                      // Clear a bit, values 0-7
   uint8_t readRegisterBit(const uint8_t reg, const uint8_t b) const;  // Read  a bit, values 0-7
 };                                                                    // of MCP7940 class definition
+/** @brief The device on an Arduino TwoWire bus, compiled into the library */
+using MCP7940_Class = MCP7940_Base<MCP7940_WireTransport>;
+template <class Transport>
+class MCP7940_EventLogBase {
+  /*!
+   @class   MCP7940_EventLog
+   @brief   Ring buffer of fixed-size event records in the battery-backed SRAM
+   @details Each record holds a sequence number, the payload and a CRC-8 over both, so that the
+            newest record can be found at startup and records torn by a power failure during the
+            write are ignored. A record is appended with a single I2C write, so it can be at most
+            BUFFER_LENGTH-1 bytes long, i.e. a payload of up to 29 bytes with the AVR Wire library.
+            The log can use all of the SRAM or only part of it so that the rest remains available
+            to readRAM() and writeRAM().
+  */
+ public:
+  MCP7940_EventLogBase(const MCP7940_Base<Transport>& rtc, const uint8_t payloadSize,
+                       const uint8_t start = 0, const uint8_t length = MCP7940_RAM_SIZE);
+  bool    begin();
+  bool    append(const void* payload);
+  bool    read(const uint8_t index, void* payload) const;
+  uint8_t readAll(void* payloads, const uint8_t maxRecords) const;
+  bool    clear();
+  uint8_t count() const { return _count; }     ///< Number of valid records in the log
+  uint8_t capacity() const { return _slots; }  ///< Maximum number of records in the log
+  uint8_t sequence() const { return _sequence; }  ///< Sequence number of the newest record
+  template <typename T>
+  bool append(const T& value) {
+    /*!
+     @brief     Template for append()
+     @details   Appends any data type whose size matches the log's payload size
+     @param[in] value Data Type "T" to append
+     @return    True if the record was written, otherwise false
+    */
+    return sizeof(T) == _payloadSize && append((const void*)&value);
+  }  // of method append()
+  template <typename T>
+  bool read(const uint8_t index, T& value) const {
+    /*!
+     @brief     Template for read()
+     @param[in] index Record number, 0 is the oldest and count()-1 the newest record
+     @param[out] value Data Type "T" to read, its size must match the log's payload size
+     @return    True if the record was read and is valid, otherwise false
+    */
+    return sizeof(T) == _payloadSize && read(index, (void*)&value);
+  }  // of method read()
+
+ private:
+  const MCP7940_Base<Transport>& _rtc;          ///< Device holding the SRAM
+  const uint8_t                  _payloadSize;  ///< Bytes of payload per record
+  const uint8_t                  _recordSize;   ///< Sequence number, payload and CRC
+  const uint8_t                  _start;        ///< SRAM address of the first record
+  const uint8_t                  _slots;        ///< Number of records which fit
+  uint8_t                        _newest{0};    ///< Slot of the newest record
+  uint8_t                        _sequence{0};  ///< Sequence number of the newest record
+  uint8_t                        _count{0};     ///< Number of valid records
+  static uint8_t crc8(const uint8_t* data, const uint8_t len);  // CRC over a record
+};  // of MCP7940_EventLog class definition
+/** @brief SRAM event log of an MCP7940_Class */
+using MCP7940_EventLog = MCP7940_EventLogBase<MCP7940_WireTransport>;
+template <class Transport>
+class MCP7940_AsyncBase {
+  /*!
+   @class   MCP7940_Async
+   @brief   Queue of RTC operations which are advanced one step at a time by poll()
+   @details deviceStart(), deviceStop(), adjust() and setAlarm() can each wait up to 255ms for the
+            OSCRUN bit. Operations queued here are split into steps of at most one register read
+            and one write, and the oscillator waits become steps which only check OSCRUN once per
+            millisecond, so that poll() never blocks for longer than a couple of I2C transactions.
+            Each queued operation is identified by a handle; its status can be queried until the
+            queue slot is reused and a callback can be set to be notified on completion.\n
+            poll() uses the Wire library and must not be called from an interrupt service routine,
+            a timer interrupt should only set a flag which causes loop() to call poll().
+  */
+ public:
+  explicit MCP7940_AsyncBase(MCP7940_Base<Transport>& rtc) : _rtc(rtc) {}  ///< Class constructor
+  uint8_t start();
+  uint8_t stop();
+  uint8_t adjust(const DateTime& dt);
+  uint8_t setAlarm(const uint8_t alarmNumber, const uint8_t alarmType, const DateTime& dt,
+                   const bool state = true);
+  uint8_t now();
+  bool    poll();
+  uint8_t status(const uint8_t handle) const;
+  bool    result(const uint8_t handle, DateTime& dt) const;
+  void    setCallback(const MCP7940_AsyncCallback callback) { _callback = callback; }  ///< Notify
+  uint8_t pending() const { return _pending; }  ///< Number of operations not yet completed
+
+ private:
+  enum Operation : uint8_t { OP_START, OP_STOP, OP_ADJUST, OP_ALARM, OP_NOW };  ///< Queued types
+  struct Job {
+    /*!
+     @struct  Job
+     @brief   One queued operation and its progress
+    */
+    uint8_t  operation{OP_NOW};  ///< Operation type
+    uint8_t  handle{0};          ///< Handle returned when queued, 0 if the slot was never used
+    uint8_t  step{0};            ///< Next step of the operation
+    uint8_t  status{MCP7940_ASYNC_UNKNOWN};  ///< Progress or final status
+    uint8_t  alarmNumber{0};     ///< setAlarm() alarm number
+    uint8_t  alarmType{0};       ///< setAlarm() alarm type
+    bool     state{false};       ///< setAlarm() alarm state
+    uint32_t started{0};         ///< millis() value when the current step was entered
+    DateTime dateTime;           ///< Date/time to set, or the date/time read by now()
+  };  // of struct Job
+  MCP7940_Base<Transport>& _rtc;                      ///< Device being driven
+  Job                   _jobs[MCP7940_ASYNC_QUEUE];   ///< Queue, finished jobs kept for status()
+  uint8_t               _head{0};                     ///< Slot of the oldest pending job
+  uint8_t               _pending{0};                  ///< Number of pending jobs
+  uint8_t               _nextHandle{1};               ///< Handle of the next queued job, never 0
+  uint32_t              _checked{0};                  ///< millis() value of the last OSCRUN check
+  MCP7940_AsyncCallback _callback{nullptr};           ///< Completion callback, if any
+  Job*    enqueue(const uint8_t operation);            // Reserve the next free queue slot
+  uint8_t run(Job& job);                               // Perform the next step of a job
+  void    advance(Job& job, const uint8_t step) const;  // Go to another step
+  uint8_t waitOscillator(Job& job, const bool running);  // OSCRUN wait step
+  const Job* find(const uint8_t handle) const;          // Slot of a handle, nullptr if gone
+};  // of MCP7940_Async class definition
+/** @brief Non-blocking operation queue of an MCP7940_Class */
+using MCP7940_Async = MCP7940_AsyncBase<MCP7940_WireTransport>;
+template <class Transport>
+class MCP7940_SchedulerBase {
+  /*!
+   @class   MCP7940_Scheduler
+   @brief   Up to MCP7940_SCHEDULER_SIZE virtual alarms multiplexed onto the two hardware alarms
+   @details The virtual alarms are kept in a binary min-heap ordered by their next fire time, so
+            add(), cancel() and firing an alarm each take O(log n). The earliest alarm is programmed
+            into ALM0 or ALM1 and the second earliest into the other one, so that the MFP output
+            signals when service() needs to be called. An alarm which is already programmed is not
+            written again and a re-arm of an enabled hardware alarm is a single 6 byte write, so
+            a typical fire costs one time read and one alarm write. The hardware alarms match the
+            full date and time except for the year, so alarms must be less than a year ahead.\n
+            The scheduler takes over both hardware alarms and the MFP alarm output, which is set to
+            active high so that it signals either alarm.
+  */
+ public:
+  explicit MCP7940_SchedulerBase(MCP7940_Base<Transport>& rtc);
+  bool    begin();
+  uint8_t add(const DateTime& first, const uint32_t periodSeconds,
+              const MCP7940_EventCallback callback);
+  bool    cancel(const uint8_t id);
+  uint8_t service();
+  bool    next(DateTime& dt) const;
+  uint8_t count() const { return _count; }  ///< Number of scheduled virtual alarms
+
+ private:
+  struct Event {
+    /*!
+     @struct  Event
+     @brief   One virtual alarm
+    */
+    uint32_t              next{0};            ///< Next fire time as UNIX time
+    uint32_t              period{0};          ///< Repeat interval in seconds, 0 fires once
+    MCP7940_EventCallback callback{nullptr};  ///< Called when the alarm fires
+  };  // of struct Event
+  static const uint8_t     NONE{0xFF};  ///< No event in a hardware alarm
+  MCP7940_Base<Transport>& _rtc;        ///< Device with the hardware alarms
+  Event    _events[MCP7940_SCHEDULER_SIZE];  ///< Virtual alarms, indexed by id-1
+  uint8_t  _heap[MCP7940_SCHEDULER_SIZE];    ///< Min-heap of event slots, free slots after _count
+  uint8_t  _position[MCP7940_SCHEDULER_SIZE];  ///< Heap index of each event slot
+  uint8_t  _count{0};                        ///< Number of events in the heap
+  uint8_t  _armedSlot[2]{NONE, NONE};        ///< Event slot programmed into ALM0 and ALM1
+  uint32_t _armedTime[2]{0, 0};              ///< Fire time programmed into ALM0 and ALM1
+  bool     _enabled[2]{false, false};        ///< ALMxEN bits as last written
+  bool     before(const uint8_t a, const uint8_t b) const;  // Heap order of two heap indexes
+  void     swap(const uint8_t a, const uint8_t b);         // Swap two heap entries
+  void     siftUp(uint8_t index);                          // Restore heap order upwards
+  void     siftDown(uint8_t index);                        // Restore heap order downwards
+  void     remove(const uint8_t index);                    // Remove a heap entry
+  void     arm();                                          // Program the two earliest alarms
+  bool     program(const uint8_t alarm, const uint8_t slot);  // Write one hardware alarm
+};  // of MCP7940_Scheduler class definition
+/** @brief Virtual alarms of an MCP7940_Class */
+using MCP7940_Scheduler = MCP7940_SchedulerBase<MCP7940_WireTransport>;
+template <class Transport>
+class MCP7940_CalibratorBase {
+  /*!
+   @class   MCP7940_Calibrator
+   @brief   Least-squares drift estimate over many reference time samples, kept in the SRAM
+   @details Each call to addSample() stores the reference time, the difference between RTC and
+            reference time and the trim in effect in an MCP7940_EventLog, so the samples survive a
+            reset as long as the battery backup is present. The drift is the slope of a straight
+            line fitted through all samples by least squares, with the offsets of older samples
+            corrected for any trim changes since. A sample which doesn't fit the samples before it
+            is ignored and if the following sample agrees with it the clock is taken as having been
+            set and the older samples are dropped. Samples whose residual is above
+            MCP7940_CALIBRATION_OUTLIER are then removed one by one. OSCTRIM is only written once
+            at least MCP7940_CALIBRATION_MIN samples remain and the standard error of the drift,
+            which also allows for the one second resolution of the clock, is below
+            MCP7940_CALIBRATION_ERROR ppm. The full SRAM holds 7 samples, the oldest sample is
+            overwritten by a new one. The RTC must be within 9 hours of the reference time.
+  */
+ public:
+  MCP7940_CalibratorBase(MCP7940_Base<Transport>& rtc, const uint8_t start = 0,
+                         const uint8_t length = MCP7940_RAM_SIZE);
+  bool    begin();
+  bool    addSample(const DateTime& reference);
+  bool    clear();
+  uint8_t count() const { return _log.count(); }    ///< Number of samples stored
+  uint8_t inliers() const { return _inliers; }      ///< Number of samples used by the fit
+  float   getPPM() const { return _ppm; }           ///< Drift, positive when the RTC is slow
+  float   getError() const { return _error; }       ///< Standard error of getPPM()
+  bool    confident() const {                       ///< True if the estimate is used for the trim
+    return _inliers >= MCP7940_CALIBRATION_MIN && _error <= MCP7940_CALIBRATION_ERROR;
+  }  // of method confident()
+
+ private:
+  static const uint8_t SAMPLE_SIZE{7};  ///< Reference time, offset and trim
+  static const uint8_t MAX_SAMPLES{MCP7940_RAM_SIZE / (SAMPLE_SIZE + 2)};  ///< Fit capacity
+  MCP7940_Base<Transport>&        _rtc;         ///< Device being calibrated
+  MCP7940_EventLogBase<Transport> _log;         ///< Samples in the SRAM
+  float                           _ppm{0};      ///< Drift of the last fit
+  float                           _error{0};    ///< Standard error of the last fit
+  uint8_t                         _inliers{0};  ///< Samples used by the last fit
+  void                            fit();        // Fit the drift through the stored samples
+  static bool agrees(const int32_t seconds, const int32_t offset);  // Same clock setting
+};  // of MCP7940_Calibrator class definition
+/** @brief Drift calibrator of an MCP7940_Class */
+using MCP7940_Calibrator = MCP7940_CalibratorBase<MCP7940_WireTransport>;
+template <class Transport>
+class MCP7940_PowerLogBase {
+  /*!
+   @class   MCP7940_PowerLog
+   @brief   History of power failures, captured at startup and kept in the SRAM
+   @details The device only holds the last power-down and power-up time-stamps, without the year,
+            and clearing PWRFAIL erases them. capture() reads all registers up to the time-stamps
+            in one burst with readSnapshot(), takes the year from the current time, appends the
+            outage to an MCP7940_EventLog and then clears PWRFAIL with a single write. Each record
+            holds the power-down time in minutes since 2000 and the outage duration in minutes, up
+            to 65535 (45 days), so the full SRAM holds 8 outages. The number of outages and the
+            total downtime in the log are kept in memory and cost no I2C traffic. The power-up time
+            is taken to be in the last year before the current time and the power-down time in the
+            year before the power-up time.
+  */
+ public:
+  MCP7940_PowerLogBase(const MCP7940_Base<Transport>& rtc, const uint8_t start = 0,
+                       const uint8_t length = MCP7940_RAM_SIZE);
+  bool     begin();
+  bool     capture();
+  bool     read(const uint8_t index, DateTime& powerDown, DateTime& powerUp) const;
+  bool     clear();
+  uint8_t  count() const { return _log.count(); }  ///< Number of outages in the log
+  uint32_t downtime() const { return _downtime; }  ///< Total minutes of the outages in the log
+
+ private:
+  static const uint8_t RECORD_SIZE{6};  ///< Power-down minute and duration
+  static const uint8_t MAX_RECORDS{MCP7940_RAM_SIZE / (RECORD_SIZE + 2)};  ///< Log capacity
+  const MCP7940_Base<Transport>&  _rtc;          ///< Device with the time-stamps
+  MCP7940_EventLogBase<Transport> _log;          ///< Outages in the SRAM
+  uint32_t                        _downtime{0};  ///< Sum of the durations in the log
+  static DateTime inYear(const DateTime& stamp, const DateTime& latest);  // Add the year
+};  // of MCP7940_PowerLog class definition
+/** @brief Power failure history of an MCP7940_Class */
+using MCP7940_PowerLog = MCP7940_PowerLogBase<MCP7940_WireTransport>;
+template <class Transport>
+class MCP7940_TimebaseBase {
+  /*!
+   @class   MCP7940_Timebase
+   @brief   Microsecond timestamps from the RTC seconds and the 1Hz square wave on the MFP pin
+   @details begin() switches the MFP to the 1Hz square wave, whose rising edge is where the seconds
+            register increments, and reads the time once. From then on edge() has to be called on
+            each rising edge by an interrupt routine, e.g. "void isr() { timebase.edge(); }"
+            attached with attachInterrupt(digitalPinToInterrupt(pin), isr, RISING). edge() only
+            latches micros() and counts the edge, so stamp() returns the RTC time with a fraction
+            in microseconds without any I2C traffic. The MCU clock is measured against the edges
+            over the last one to two windows of MCP7940_TIMEBASE_WINDOW seconds. getDrift()
+            returns the result and stamp() uses it to scale the fraction. A missed edge is
+            detected from the interval and counted, a second edge within half a second is
+            ignored. The MFP can't be used for alarms while the timebase is in use.
+  */
+ public:
+  explicit MCP7940_TimebaseBase(MCP7940_Base<Transport>& rtc) : _rtc(rtc) {}  ///< Constructor
+  bool    begin(const uint16_t timeoutMs = 2000);
+  void    edge();
+  bool    stamp(uint32_t& seconds, uint32_t& microseconds) const;
+  bool    stamp(const uint32_t atMicros, uint32_t& seconds, uint32_t& microseconds) const;
+  int32_t getDrift() const;
+
+ private:
+  MCP7940_Base<Transport>& _rtc;          ///< Device driving the MFP
+  volatile uint32_t _edges{0};            ///< Rising edges counted by edge()
+  volatile uint32_t _edgeMicros{0};       ///< micros() at the last edge
+  volatile int32_t  _excess{0};           ///< Sum of edge intervals above 1s in this window
+  volatile uint16_t _measured{0};         ///< Edge intervals in this window
+  volatile int32_t  _windowExcess{0};     ///< Sum of edge intervals above 1s in the last window
+  volatile uint16_t _windowMeasured{0};   ///< Edge intervals in the last window
+  uint32_t          _baseSeconds{0};      ///< UNIX time of the second started by edge _baseEdges
+  uint32_t          _baseEdges{0};        ///< Edge count when _baseSeconds started
+  bool              _synced{false};       ///< begin() has succeeded
+  uint32_t          edgeCount() const;    // Read _edges with interrupts off
+};  // of MCP7940_Timebase class definition
+/** @brief Microsecond timestamps from an MCP7940_Class */
+using MCP7940_Timebase = MCP7940_TimebaseBase<MCP7940_WireTransport>;
+/***************************************************************************************************
+** The library is compiled with these instantiations, see MCP7940_Impl.h for other transports     **
+***************************************************************************************************/
+extern template class MCP7940_Base<MCP7940_WireTransport>;
+extern template class MCP7940_EventLogBase<MCP7940_WireTransport>;
+extern template class MCP7940_AsyncBase<MCP7940_WireTransport>;
+extern template class MCP7940_SchedulerBase<MCP7940_WireTransport>;
+extern template class MCP7940_CalibratorBase<MCP7940_WireTransport>;
+extern template class MCP7940_PowerLogBase<MCP7940_WireTransport>;
+extern template class MCP7940_TimebaseBase<MCP7940_WireTransport>;
 #endif
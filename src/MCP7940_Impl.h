@@ -0,0 +1,2470 @@
+/*! @file MCP7940_Impl.h
+ @section MCP7940_Impl_intro_section Description
+
+Arduino Library for the MCP7940M and MCP7940N Real-Time Clock devices\n\n
+Definitions of the class templates declared in MCP7940.h. The library compiles them for the default
+MCP7940_WireTransport, so sketches using "Wire" only need MCP7940.h. A sketch with its own transport
+class includes this header after MCP7940.h, so that the compiler can generate MCP7940_Base and the
+helper classes for that transport as well. See main library header file for details
+*/
+#ifndef MCP7940_Impl_h
+  /** @brief  Guard code definition */
+  #define MCP7940_Impl_h  // Define the name inside guard code
+  #include "MCP7940.h"
+/***************************************************************************************************
+** Implementation of MCP7940_Base                                                                 **
+***************************************************************************************************/
+template <class Transport>
+bool MCP7940_Base<Transport>::begin(const uint32_t i2cSpeed) const {
+  /*!
+      @brief     Start I2C device communications
+      @details   Starts I2C comms with the device, using a default speed if one is not specified
+      @param[in] i2cSpeed defaults to I2C_STANDARD_MODE, otherwise use speed in Herz
+      @return    true if successfully started communication, otherwise false
+  */
+  MCP7940_INSTRUMENT(begin);
+  return begin(SDA, SCL, i2cSpeed);
+}  // of method begin()
+template <class Transport>
+bool MCP7940_Base<Transport>::begin(const uint8_t sda, const uint8_t scl,
+                                    const uint32_t i2cSpeed) const {
+  /*!
+      @brief     Start I2C device communications
+      @details   Starts I2C comms with the device, using default SDA and SCL ports as well as speed
+                 if they are not specified
+      @param[in] sda defaults to PIN_WIRE_SDA, otherwise use pin (ignored if not ESP8266)
+      @param[in] scl defaults to PIN_WIRE_SCL, otherwise use pin (ignored if not ESP8266)
+      @param[in] i2cSpeed defaults to I2C_STANDARD_MODE, otherwise use speed in Herz
+      @return    true if successfully started communication, otherwise false
+  */
+  MCP7940_INSTRUMENT(begin);
+  _bus.begin(sda, scl, i2cSpeed);                     // Start I2C as master device
+  const uint8_t status = _bus.probe(MCP7940_ADDRESS);  // Probe the address
+  MCP7940_RECORD(0, status != 0);                      // Count the probe
+  if (status == 0)                                // If there a device present
+  {
+    clearRegisterBit(MCP7940_RTCHOUR, MCP7940_12_24);  // Use 24 hour clock
+    setRegisterBit(MCP7940_CONTROL, MCP7940_ALMPOL);   // assert alarm low, default high
+    return true;                                       // return success
+  } else {
+    return false;  // return error if no device found
+  }                // of if-then-else device detected
+}  // of method begin()
+
+template <class Transport>
+bool MCP7940_Base<Transport>::busRetry(const uint8_t error, uint8_t& attempt,
+                                       const uint32_t start) const {
+  /*!
+      @brief     Record a failed transfer and decide whether to try it again
+      @details   A transfer is repeated up to the number of retries set with setRetryPolicy(), but
+                 not once the call's deadline has passed. Together with the bus timeout this
+                 bounds the time any register access can take
+      @param[in] error  MCP7940_ERROR_NACK or MCP7940_ERROR_SHORT_READ
+      @param[in] attempt Number of repeats done so far, incremented when another one is made
+      @param[in] start  micros() value when the transfer was first attempted
+      @return    true if the transfer should be repeated, otherwise false
+  */
+  if (attempt < _retries) {
+    if (_deadline == 0 || micros() - start < _deadline) {
+      ++attempt;
+      ++_retryCount;
+      return true;
+    }                                  // of if-then deadline not reached
+    _lastError = MCP7940_ERROR_DEADLINE;
+  } else {
+    _lastError = error;
+  }  // of if-then-else retries left
+  ++_errorCount;
+  return false;
+}  // of method busRetry()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::busRead(const uint8_t device, const uint8_t reg, uint8_t* data,
+                                         const uint8_t len) const {
+  /*!
+      @brief      Read registers through the transport, repeating failed or short reads
+      @param[in]  device I2C address
+      @param[in]  reg    First register address
+      @param[out] data   Buffer for the bytes read
+      @param[in]  len    Number of bytes to read
+      @return     Number of bytes read, less than "len" on an error
+  */
+  const uint32_t start = _retries ? micros() : 0;
+  uint8_t        attempt{0};
+  uint8_t        received;
+  do {
+    received = _bus.writeRead(device, reg, data, len);  // Address write then read
+    MCP7940_RECORD(1, false);                            // Count the address write
+    MCP7940_RECORD(received, received != len);           // Count the read
+  } while (received != len &&
+           busRetry(received ? MCP7940_ERROR_SHORT_READ : MCP7940_ERROR_NACK, attempt, start));
+  return received;
+}  // of method busRead()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::busWrite(const uint8_t device, const uint8_t reg,
+                                          const uint8_t* data, const uint8_t len) const {
+  /*!
+      @brief     Write registers through the transport, repeating failed writes
+      @details   Register writes are idempotent, so a write which may or may not have reached the
+                 device can safely be repeated
+      @param[in] device I2C address
+      @param[in] reg    First register address
+      @param[in] data   Bytes to write
+      @param[in] len    Number of bytes to write
+      @return    0 on success, otherwise the transport's error code
+  */
+  const uint32_t start = _retries ? micros() : 0;
+  uint8_t        attempt{0};
+  uint8_t        status;
+  do {
+    status = _bus.write(device, reg, data, len);  // Burst write
+    MCP7940_RECORD(1 + len, status != 0);         // Count the write
+  } while (status != 0 && busRetry(MCP7940_ERROR_NACK, attempt, start));
+  return status;
+}  // of method busWrite()
+template <class Transport>
+void MCP7940_Base<Transport>::setRetryPolicy(const uint8_t retries, const uint32_t deadlineMicros) {
+  /*!
+      @brief     Set how often failed bus transfers are repeated
+      @details   Each failed or short transfer is repeated up to "retries" times. No repeat is
+                 started once "deadlineMicros" have passed since the first attempt, so a single
+                 register access takes at most the deadline plus one transfer, each of which is
+                 limited by setBusTimeout(). The default is no retries, as in earlier versions
+      @param[in] retries        Number of repeats, 0 reports the first failure
+      @param[in] deadlineMicros Time limit for the repeats in microseconds, 0 for no limit
+  */
+  _retries  = retries;
+  _deadline = deadlineMicros;
+}  // of method setRetryPolicy()
+template <class Transport>
+void MCP7940_Base<Transport>::setBusTimeout(const uint32_t timeoutMicros) const {
+  /*!
+      @brief     Limit how long a single transaction may block on a stuck bus
+      @details   Passed on to the transport, see MCP7940_WireTransport::setTimeout()
+      @param[in] timeoutMicros Timeout in microseconds, 0 turns the timeout off
+  */
+  _bus.setTimeout(timeoutMicros);
+}  // of method setBusTimeout()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::getLastError() const {
+  /*!
+      @brief     Return and clear the last bus error
+      @details   Every method which accesses the device records a failed transfer here, so a call
+                 after, e.g., now() or getAlarm() tells whether the value returned is valid. The
+                 overloads of the getters with an output parameter return this as a bool instead
+      @return    MCP7940_ERROR_NONE if no transfer failed since the last call, otherwise the last
+                 MCP7940_ERROR_NACK, MCP7940_ERROR_SHORT_READ or MCP7940_ERROR_DEADLINE
+  */
+  const uint8_t error = _lastError;
+  _lastError          = MCP7940_ERROR_NONE;
+  return error;
+}  // of method getLastError()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::readByte(const uint8_t addr) const {
+  /*!
+      @brief     Read a single byte from the device address
+      @param[in] addr I2C device register address to read from
+      @return    Byte read from the I2C device, 0 on a bus error and getLastError() is set
+  */
+  uint8_t dataByte{0};
+  I2C_read(addr, dataByte);
+  return dataByte;
+}  // of method readByte()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::cacheSlot(const uint8_t reg) {
+  /*!
+      @brief     Return the shadow cache slot used for a register
+      @param[in] reg Register address
+      @return    Slot number or MCP7940_CACHE_SIZE if the register is not cached
+  */
+  switch (reg) {
+    case MCP7940_CONTROL: return 0;
+    case MCP7940_OSCTRIM: return 1;
+    default: return MCP7940_CACHE_SIZE;
+  }  // of switch for each cached register
+}  // of method cacheSlot()
+template <class Transport>
+void MCP7940_Base<Transport>::cacheUpdate(const uint8_t address, const uint8_t* data,
+                                          const uint8_t len) const {
+  /*!
+      @brief     Copy bytes transferred over I2C into the shadow cache
+      @details   Called by I2C_read() and I2C_write() after every successful transfer so that the
+                 cache is write-through and refreshed for free by any burst covering the registers
+      @param[in] address First register address transferred
+      @param[in] data    Bytes transferred
+      @param[in] len     Number of bytes
+  */
+  if (address >= MCP7940_RAM_ADDRESS) return;  // SRAM is never cached
+  for (uint8_t i = 0; i < len; ++i) {
+    uint8_t slot = cacheSlot((address + i) & 0x1F);  // RTCC address pointer rolls over at 0x1F
+    if (slot < MCP7940_CACHE_SIZE) {
+      _cache[slot] = data[i];
+      _cacheValid |= 1 << slot;
+    }  // of if-then cached register
+  }    // of for-next each byte
+}  // of method cacheUpdate()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::readCached(const uint8_t reg) const {
+  /*!
+      @brief     Read a register from the shadow cache, or from the device if not cached
+      @param[in] reg Register address
+      @return    Register contents
+  */
+  uint8_t slot = cacheSlot(reg);
+  if (_cacheEnabled && slot < MCP7940_CACHE_SIZE && bitRead(_cacheValid, slot)) {
+    return _cache[slot];
+  }  // of if-then cache hit
+  return readByte(reg);  // fills the cache as a side effect
+}  // of method readCached()
+template <class Transport>
+void MCP7940_Base<Transport>::setCache(const bool state) {
+  /*!
+      @brief     Turn the register shadow cache on or off
+      @details   When on, a write-through copy of the CONTROL and OSCTRIM registers is kept so that
+                 bit updates cost a single write and configuration getters need no I2C traffic.
+                 RTCWKDAY and ALMxWKDAY are never cached, as the device changes the weekday, the
+                 OSCRUN and PWRFAIL bits and the ALMxIF flags on its own and writing back a stale
+                 copy would clear a power failure or an alarm
+      @param[in] state true to turn the cache on, false to turn it off
+  */
+  _cacheEnabled = state;
+  invalidateCache();
+}  // of method setCache()
+template <class Transport>
+bool MCP7940_Base<Transport>::refreshCache() const {
+  /*!
+      @brief     Reload all cached registers from the device
+      @details   A single 2 byte burst read of CONTROL and OSCTRIM covers all cached registers
+      @return    true on success, false if the cache is off or the read failed
+  */
+  MCP7940_INSTRUMENT(refreshCache);
+  uint8_t block[MCP7940_OSCTRIM - MCP7940_CONTROL + 1];
+  if (!_cacheEnabled) return false;
+  invalidateCache();
+  return I2C_read(MCP7940_CONTROL, block) == sizeof(block);
+}  // of method refreshCache()
+template <class Transport>
+void MCP7940_Base<Transport>::invalidateCache() const {
+  /*!
+      @brief     Mark all cached registers as stale so that they are re-read on next use
+  */
+  _cacheValid = 0;
+}  // of method invalidateCache()
+template <class Transport>
+void MCP7940_Base<Transport>::clearRegisterBit(const uint8_t reg, const uint8_t b) const {
+  /*!
+      @brief     clears a specified bit in a register on the device
+      @param[in] reg Register to write to
+      @param[in] b   Bit (0-7) to clear
+  */
+  I2C_write(reg, (uint8_t)(readCached(reg) & ~(1 << b)));
+}  // of method clearRegisterBit()
+template <class Transport>
+void MCP7940_Base<Transport>::setRegisterBit(const uint8_t reg, const uint8_t b) const {
+  /*!
+      @brief     sets a specified bit in a register on the device
+      @param[in] reg Register to write to
+      @param[in] b   Bit (0-7) to set
+  */
+  I2C_write(reg, (uint8_t)(readCached(reg) | (1 << b)));
+}  // of method setRegisterBit()
+template <class Transport>
+void MCP7940_Base<Transport>::writeRegisterBit(const uint8_t reg, const uint8_t b,
+                                               const bool bitvalue) const {
+  /*!
+      @brief     Sets or clears the specified bit based on bitvalue
+      @param[in] reg      Register to write to
+      @param[in] b        Bit (0-7) to set
+      @param[in] bitvalue boolean with "true" for 1 and "false" for 0
+  */
+  bitvalue ? setRegisterBit(reg, b) : clearRegisterBit(reg, b);
+}  // of method writeRegisterBit()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::readRegisterBit(const uint8_t reg, const uint8_t b) const {
+  /*!
+      @brief     read a specific bit from a register
+      @details   CONTROL and OSCTRIM bits may come from the cache, all others are read from the
+                 device
+      @param[in] reg      Register to read from
+      @param[in] b        Bit (0-7) to read
+      @return    0 for "false" and 1 for "true"
+   */
+  return bitRead(readCached(reg), b);
+}  // of method readRegisterBit()
+template <class Transport>
+bool MCP7940_Base<Transport>::deviceStatus() const {
+  /*!
+      @brief  checks to see if the MCP7940 crystal has been turned on or off
+      @brief  Sets the status register to turn on the device clock
+      @return Success status true if the crystal is on, otherwise false if off or on a bus error
+   */
+  MCP7940_INSTRUMENT(deviceStatus);
+  return readRegisterBit(MCP7940_RTCSEC, MCP7940_ST);
+}  // of method DeviceStatus
+template <class Transport>
+bool MCP7940_Base<Transport>::deviceStart() const {
+  /*!
+      @brief  Start the MCP7940 device
+      @details Sets the status register to turn on the device clock
+      @return Success status true if successful otherwise false
+   */
+  MCP7940_INSTRUMENT(deviceStart);
+  uint8_t oscillatorStatus{0};                 // define temporary variable
+  setRegisterBit(MCP7940_RTCSEC, MCP7940_ST);  // Set the ST bit
+  for (uint8_t j = 0; j < 255; j++)            // Loop until changed or overflow
+  {
+    oscillatorStatus =
+        readRegisterBit(MCP7940_RTCWKDAY, MCP7940_OSCRUN);  // Wait for oscillator to start
+    if (oscillatorStatus) break;                            // Exit loop on success
+    delay(1);                                               // Allow oscillator time to start
+  }                                                         // of for-next oscillator loop
+  return oscillatorStatus;
+}  // of method deviceStart
+template <class Transport>
+bool MCP7940_Base<Transport>::deviceStop() const {
+  /*!
+      @brief  Stop the MCP7940 device
+      @details Sets the status register to turn off the device clock
+      @return true if the oscillator is still running, otherwise 0 if the oscillator has stopped
+   */
+  MCP7940_INSTRUMENT(deviceStop);
+  clearRegisterBit(MCP7940_RTCSEC, MCP7940_ST);  // clear the ST bit.
+  uint8_t oscillatorStatus{0};                   // temporary status variable
+  for (uint8_t j = 0; j < 255; j++) {            // Loop until changed or overflow
+    oscillatorStatus =
+        readRegisterBit(MCP7940_RTCWKDAY, MCP7940_OSCRUN);  // Wait for oscillator to stop
+    if (!oscillatorStatus) break;                           // Exit loop on success
+    delay(1);                                               // Allow oscillator time to stop
+  }                                                         // of for-next oscillator loop
+  return oscillatorStatus;
+}  // of method deviceStop
+template <class Transport>
+bool MCP7940_Base<Transport>::readNow(DateTime& dt) const {
+  /*!
+      @brief      reads the current date/time from the device, bypassing the cached clock
+      @param[out] dt DateTime class value for the current Date/Time, unchanged on a bus error
+      @return     true if the registers were read, otherwise false
+   */
+  uint8_t readBuffer[7] = {0};
+  if (I2C_read(MCP7940_RTCSEC, readBuffer) != sizeof(readBuffer)) return false;
+  dt = decodeTime(readBuffer);
+  return true;
+}  // of method readNow()
+template <class Transport>
+bool MCP7940_Base<Transport>::readSnapshot(MCP7940_Snapshot& snapshot) const {
+  /*!
+      @brief      Read all timekeeping, alarm and power-fail registers at once
+      @details    Registers 0x00 to 0x1F are read in a single 32 byte burst, or in two with a Wire
+                  buffer smaller than 32 bytes, instead of the dozens of transactions the
+                  individual getters need. The snapshot's accessors then decode them in memory
+      @param[out] snapshot Register copy to fill
+      @return     true if all registers were read, otherwise false and snapshot.valid() is false
+  */
+  MCP7940_INSTRUMENT(readSnapshot);
+  uint8_t done{0};  // Registers read so far
+  while (done < MCP7940_SNAPSHOT_SIZE) {
+    const uint8_t chunk = MCP7940_SNAPSHOT_SIZE - done > BUFFER_LENGTH
+                              ? BUFFER_LENGTH
+                              : MCP7940_SNAPSHOT_SIZE - done;
+    if (busRead(MCP7940_ADDRESS, done, snapshot._registers + done, chunk) != chunk) break;
+    done += chunk;
+  }  // of while registers left to read
+  snapshot._valid = done == MCP7940_SNAPSHOT_SIZE;
+  if (snapshot._valid && _cacheEnabled) {
+    cacheUpdate(MCP7940_RTCSEC, snapshot._registers, MCP7940_SNAPSHOT_SIZE);  // Refresh cache
+  }  // of if-then cache in use
+  return snapshot._valid;
+}  // of method readSnapshot()
+template <class Transport>
+DateTime MCP7940_Base<Transport>::now() const {
+  /*!
+      @brief   returns the current date/time
+      @details If the device is stopped then the stop time is returned. When the cached clock is
+               enabled with setNowCache() the device is only read when the resync interval has
+               passed, otherwise the time is extrapolated from the last reading using millis(). A
+               resync always anchors the cached clock to the device time, so a millis() frequency
+               error can't accumulate. The returned time never goes backwards, also not across
+               adjust() or calibrate(): if the device is behind the last value returned then that
+               value is held until the device catches up, so after setting the clock back by an
+               hour now() holds for an hour. setNowCache() starts the cached clock afresh and
+               returns the device time at once. On a bus error 2000-01-01 00:00:00 is returned, or
+               the cached clock keeps running without a resync, and getLastError() is set
+      @return  DateTime class value for the current Date/Time
+   */
+  MCP7940_INSTRUMENT(now);
+  DateTime dt;
+  if (!_nowInterval) {  // Cached clock not in use
+    readNow(dt);
+    return dt;
+  }  // of if-then not cached
+  uint32_t elapsed = millis() - _nowMillis;
+  if ((!_nowValid || elapsed >= _nowInterval) && readNow(dt)) {  // Resync with the device
+    uint32_t deviceTime = dt.unixtime();
+    _nowMillis          = millis();
+    _nowPhase           = false;  // Position within the second isn't known
+    _nowTime            = deviceTime;  // now() holds _nowLast until this passes it
+    _nowValid           = true;
+    elapsed             = 0;
+  }  // of if-then resync needed
+  if (!_nowValid) return dt;  // Never read successfully
+  uint32_t cachedTime = _nowTime + elapsed / 1000;
+  if (cachedTime > _nowLast) _nowLast = cachedTime;
+  return DateTime(_nowLast);
+}  // of method now
+template <class Transport>
+bool MCP7940_Base<Transport>::now(DateTime& dt) const {
+  /*!
+      @brief      returns the current date/time and whether it is valid (overloaded)
+      @param[out] dt DateTime value returned by now()
+      @return     true if no transfer failed, otherwise false and "dt" is 2000-01-01 00:00:00 or
+                  the cached clock without a resync
+  */
+  const uint32_t errors = _errorCount;
+  dt                    = now();
+  return _errorCount == errors;
+}  // of method now()
+template <class Transport>
+void MCP7940_Base<Transport>::setNowCache(const uint32_t resyncMillis) {
+  /*!
+      @brief     Turns the cached clock used by now() on or off
+      @details   With the cached clock on, now() reads the device once and then extrapolates the
+                 time using millis() until "resyncMillis" milliseconds have passed. Calling
+                 clockTick() on each 1Hz MFP edge aligns the cached clock to the device's seconds
+                 without any I2C traffic
+      @param[in] resyncMillis Milliseconds between device reads, 0 turns the cached clock off
+  */
+  _nowInterval = resyncMillis;
+  _nowValid    = false;  // Force a device read on the next call
+  _nowLast     = 0;
+}  // of method setNowCache()
+template <class Transport>
+void MCP7940_Base<Transport>::clockTick() const {
+  /*!
+      @brief   Aligns the cached clock to the device's seconds
+      @details Call this on each rising edge of the MFP pin when it outputs the 1Hz square wave,
+               which is when the seconds register increments, for example from loop() after an
+               interrupt routine has set a flag. The cached seconds are
+               advanced to the edge and the millis() anchor is moved to it, so that the cached clock
+               is no longer up to a second behind the device
+  */
+  if (!_nowValid) return;  // Nothing to align until the first device read
+  const uint32_t ms      = millis();
+  const uint32_t elapsed = ms - _nowMillis;
+  if (_nowPhase) {
+    _nowTime += (elapsed + 500) / 1000;  // Round to the nearest whole number of edges
+  } else {
+    _nowTime += elapsed / 1000 + 1;  // First edge after a device read
+  }                                  // of if-then-else phase known
+  _nowMillis = ms;
+  _nowPhase  = true;
+}  // of method clockTick()
+template <class Transport>
+uint32_t MCP7940_Base<Transport>::getNowStaleness() const {
+  /*!
+      @brief   Returns how far the cached clock might be off
+      @details This is the number of milliseconds since the cached clock was last aligned with the
+               device, either by reading it or by a clockTick(), plus 1000 when the position within
+               the current second isn't known because no clockTick() has been seen since the last
+               device read
+      @return  Staleness bound in milliseconds, 0 if the cached clock is not in use
+  */
+  if (!_nowInterval || !_nowValid) return 0;
+  return millis() - _nowMillis + (_nowPhase ? 0 : 1000);
+}  // of method getNowStaleness()
+template <class Transport>
+DateTime MCP7940_Base<Transport>::getPowerDown() const {
+  /*!
+      @brief   returns the date/time that the power went off
+      @details This is set back to zero once the power fail flag is reset. On a bus error the
+               month is 0, getPowerFailTimes() returns a status instead
+      @return  DateTime class value for the power-down Date/Time
+   */
+  MCP7940_INSTRUMENT(getPowerDown);
+  uint8_t readBuffer[4] = {0};
+  I2C_read(MCP7940_PWRDNMIN, readBuffer);
+  return decodePowerFail(readBuffer);
+}  // of method getPowerDown()
+template <class Transport>
+DateTime MCP7940_Base<Transport>::getPowerUp() const {
+  /*!
+      @brief   returns the date/time that the power went back on
+      @details On a bus error the month is 0, getPowerFailTimes() returns a status instead
+      @return  DateTime class value for the power-on Date/Time
+   */
+  MCP7940_INSTRUMENT(getPowerUp);
+  uint8_t readBuffer[4] = {0};
+  I2C_read(MCP7940_PWRUPMIN, readBuffer);
+  return decodePowerFail(readBuffer);
+}  // of method getPowerUp()
+template <class Transport>
+bool MCP7940_Base<Transport>::getPowerFailTimes(DateTime& powerDown, DateTime& powerUp) const {
+  /*!
+      @brief   returns both power-fail time-stamps using a single 8 byte burst read
+      @param[out] powerDown Date/time that the power went off
+      @param[out] powerUp   Date/time that the power went back on
+      @return  true if the registers were read successfully, otherwise false
+   */
+  MCP7940_INSTRUMENT(getPowerFailTimes);
+  uint8_t readBuffer[8] = {0};
+  bool    success       = I2C_read(MCP7940_PWRDNMIN, readBuffer) == sizeof(readBuffer);
+  powerDown             = decodePowerFail(readBuffer);
+  powerUp               = decodePowerFail(readBuffer + 4);
+  return success;
+}  // of method getPowerFailTimes()
+template <class Transport>
+void MCP7940_Base<Transport>::adjust() {
+  /*!
+      @brief   sets the current date/time (overloaded)
+      @details This is an overloaded function. With no parameters then the RTC is set to the
+     date/time when the library was compiled. The __DATE__ and __TIME__ strings are parsed by the
+     compiler into the MCP7940_BUILD_TIME constant, so nothing is copied or parsed at runtime
+  */
+  MCP7940_INSTRUMENT(adjust);
+  adjust(MCP7940_BUILD_TIME);  // Set to library compile Date/Time, parsed by the compiler
+}  // of method "adjust()"
+template <class Transport>
+void MCP7940_Base<Transport>::adjust(const DateTime& dt, const bool burst) {
+  /*!
+     @brief   sets the current date/time (overloaded)
+     @details This is an overloaded function. Set to the DateTime class instance value. The
+     oscillator is stopped during the process and is restarted upon completion.\n
+     In burst mode RTCSEC is written once with the ST bit clear and OSCRUN is polled until the
+     oscillator has stopped, as deviceStop() does, the last poll also giving the VBATEN and
+     PWRFAIL bits to keep. With the oscillator stopped no increment can be pending, so RTCSEC
+     through RTCYEAR are then loaded in a single auto-increment write with ST set. This restarts
+     the oscillator with its divider chain reset, so the first increment comes a second later. The
+     weekday is rewritten afterwards for silicon errata issue 4. This costs about 5 transactions
+     and 1.8ms of bus time at 100kHz instead of 24 transactions and 5.7ms, so about 3 to 5 times
+     less depending on how long the oscillator takes to stop.
+     @param[in] dt    Date/time to set
+     @param[in] burst Set to true to use the burst mode
+  */
+  MCP7940_INSTRUMENT(adjust);
+  if (burst) {
+    I2C_write(MCP7940_RTCSEC, (uint8_t)0);  // Clear ST, the seconds are overwritten below
+    uint8_t wkday{0};
+    for (uint8_t j = 0; j < 255; j++) {  // Loop until changed or overflow
+      wkday = readByte(MCP7940_RTCWKDAY);
+      if (!(wkday & (1 << MCP7940_OSCRUN))) break;  // Exit loop when the oscillator has stopped
+      delay(1);                                      // Allow oscillator time to stop
+    }                                                // of for-next oscillator loop
+    wkday = (wkday & ((1 << MCP7940_PWRFAIL) | (1 << MCP7940_VBATEN))) | dt.dayOfTheWeek();
+    uint8_t block[7];
+    encodeTime(dt, wkday, block);        // RTCSEC has ST set
+    I2C_write(MCP7940_RTCSEC, block);    // Load all timekeeping registers, restarting the clock
+    I2C_write(MCP7940_RTCWKDAY, wkday);  // Silicon errata issue 4
+  } else {
+    deviceStop();  // Stop the oscillator
+    I2C_write(MCP7940_RTCSEC, int2bcd(dt.second()));
+    I2C_write(MCP7940_RTCMIN, int2bcd(dt.minute()));
+    I2C_write(MCP7940_RTCHOUR, int2bcd(dt.hour()));
+    weekdayWrite(dt.dayOfTheWeek());                        // Update the weekday
+    I2C_write(MCP7940_RTCMTH, int2bcd(dt.month()));         // Month, ignore R/O leapyear bit
+    I2C_write(MCP7940_RTCDATE, int2bcd(dt.day()));          // Write the day of month
+    I2C_write(MCP7940_RTCYEAR, int2bcd(dt.year() - 2000));  // Write the year
+    deviceStart();                                          // Restart the oscillator
+    weekdayWrite(dt.dayOfTheWeek());                        // Silicon errata issue 4
+  }                                                         // of if-then-else burst mode
+  adjusted(dt);                                             // Store time of last change
+}  // of method adjust
+template <class Transport>
+bool MCP7940_Base<Transport>::adjustPrepare(const DateTime& dt, uint8_t* block) {
+  /*!
+     @brief   Stop the oscillator and build the timekeeping register block
+     @details Only the burst write remains to be done, so the write can be started with the lowest
+              possible latency. Restarting the oscillator resets its divider chain, so the first
+              second of the new time starts when the RTCSEC byte has been received
+     @param[in]  dt    Date/time to set
+     @param[out] block 7 register values for RTCSEC to RTCYEAR
+     @return  true if the oscillator has stopped and the write is ready, otherwise false
+  */
+  if (deviceStop()) return false;  // Oscillator didn't stop
+  encodeTime(dt, (readByte(MCP7940_RTCWKDAY) & B11111000) | dt.dayOfTheWeek(), block);
+  return true;
+}  // of method adjustPrepare()
+template <class Transport>
+bool MCP7940_Base<Transport>::adjustFinish(const DateTime& dt, const uint8_t* block,
+                                           const uint32_t reference, uint32_t& latency) {
+  /*!
+     @brief      Send the write built by adjustPrepare() and measure how long it took
+     @param[in]  dt        Date/time being set
+     @param[in]  block     Register block built by adjustPrepare()
+     @param[in]  reference micros() value at which the new time should have started
+     @param[out] latency   Microseconds from the reference to the end of the write
+     @return     true if the write succeeded, otherwise false
+  */
+  const uint8_t status = _bus.write(MCP7940_ADDRESS, MCP7940_RTCSEC, block, 7);  // Start oscillator
+  latency              = micros() - reference;
+  MCP7940_RECORD(8, status != 0);  // Count the write
+  if (status != 0) {                // Not repeated, a late retry would defeat the alignment
+    _lastError = MCP7940_ERROR_NACK;
+    ++_errorCount;
+    invalidateCache();
+    deviceStart();  // Don't leave the clock stopped
+    return false;
+  }                                 // of if-then write failed
+  weekdayWrite(dt.dayOfTheWeek());  // Silicon errata issue 4
+  adjusted(dt, true);
+  return true;
+}  // of method adjustFinish()
+template <class Transport>
+bool MCP7940_Base<Transport>::adjustAtMicros(const DateTime& dt, const uint32_t atMicros,
+                                             uint32_t& latency) {
+  /*!
+     @brief      Set the date/time so that the new second starts at a given micros() value
+     @details    The oscillator is stopped and the burst write is prepared beforehand, then the
+                 method spins until micros() reaches "atMicros" and only sends the write. This
+                 aligns the RTC's second boundary to within the write latency instead of the up
+                 to one second error of adjust(). The latency is mostly the I2C time of the
+                 address, register and RTCSEC bytes, so passing "atMicros" earlier by the latency
+                 of a previous call compensates for it. "atMicros" must be less than 35 minutes
+                 in the future
+     @param[in]  dt       Date/time at "atMicros"
+     @param[in]  atMicros micros() value at which the new time starts, e.g. a PPS edge plus offset
+     @param[out] latency  Microseconds from "atMicros" to the end of the write
+     @return     true if the clock was set, otherwise false
+  */
+  MCP7940_INSTRUMENT(adjustAtMicros);
+  uint8_t block[7];
+  latency = 0;
+  if (!adjustPrepare(dt, block)) return false;
+  while ((int32_t)(micros() - atMicros) < 0) {
+  }  // of while waiting for the target time
+  return adjustFinish(dt, block, atMicros, latency);
+}  // of method adjustAtMicros()
+template <class Transport>
+bool MCP7940_Base<Transport>::adjustOnEdge(const DateTime& dt, const uint8_t pin, uint32_t& latency,
+                                           const uint16_t timeoutMs) {
+  /*!
+     @brief      Set the date/time on the rising edge of a reference pulse, e.g. a GPS PPS output
+     @details    The oscillator is stopped and the burst write is prepared beforehand, then the pin
+                 is polled for a low to high transition and the write is sent immediately. If no
+                 edge is seen within the timeout the oscillator is restarted with the old time,
+                 which will then be behind by the time spent waiting
+     @param[in]  dt        Date/time at the edge
+     @param[in]  pin       Digital input pin carrying the reference pulse
+     @param[out] latency   Microseconds from detecting the edge to the end of the write
+     @param[in]  timeoutMs Maximum time to wait for the edge in milliseconds
+     @return     true if the clock was set, otherwise false
+  */
+  MCP7940_INSTRUMENT(adjustOnEdge);
+  uint8_t block[7];
+  latency = 0;
+  if (!adjustPrepare(dt, block)) return false;
+  const uint32_t start = millis();
+  bool           low{false};  // A low level has been seen, so the next high is an edge
+  while (millis() - start < timeoutMs) {
+    if (digitalRead(pin) == LOW) {
+      low = true;
+    } else if (low) {
+      return adjustFinish(dt, block, micros(), latency);
+    }  // of if-then-else rising edge
+  }    // of while waiting for the edge
+  deviceStart();  // Restart the clock with the old time
+  return false;
+}  // of method adjustOnEdge()
+template <class Transport>
+void MCP7940_Base<Transport>::adjusted(const DateTime& dt, const bool onEdge) {
+  /*!
+     @brief     Record that the clock has just been set, used by adjust() and MCP7940_Async
+     @param[in] dt     Date/time the clock was set to
+     @param[in] onEdge True if the clock was set at the start of a second
+  */
+  _SetUnixTime = dt.unixtime();  // Store time of last change
+  if (_nowInterval) {            // Re-anchor the cached clock
+    _nowTime   = _SetUnixTime;  // _nowLast is kept, so now() doesn't go back if set back
+    _nowMillis = millis();
+    _nowPhase  = onEdge;
+    _nowValid  = true;
+  }  // of if-then cached clock in use
+}  // of method adjusted()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::weekdayRead() const {
+  /*!
+      @brief   return the weekday number from the RTC
+      @details This number is user-settable and is incremented when the day shifts. It is set as
+     part of the adjust() method where Monday is weekday 1
+      @return  Values 1-7 for the current weekday, 0 on a bus error
+  */
+  MCP7940_INSTRUMENT(weekdayRead);
+  return readByte(MCP7940_RTCWKDAY) & 0x07;  // no need to convert, values 1-7
+}  // of method weekdayRead()
+template <class Transport>
+bool MCP7940_Base<Transport>::weekdayRead(uint8_t& dow) const {
+  /*!
+      @brief      return the weekday number and whether it could be read (overloaded)
+      @param[out] dow Values 1-7 for the current weekday, 0 on a bus error
+      @return     true if the register was read, otherwise false
+  */
+  const uint32_t errors = _errorCount;
+  dow                   = weekdayRead();
+  return _errorCount == errors;
+}  // of method weekdayRead()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::weekdayWrite(const uint8_t dow) const {
+  /*!
+      @brief   set the RTC weekday number
+      @details This number is user-settable and is incremented when the day shifts. The library uses
+     1 for Monday and 7 for Sunday
+      @param[in] dow Day of week (1-7)
+      @return    Values 1-7 for the day set, returns MCP7940 value if "dow" is out of range
+  */
+  MCP7940_INSTRUMENT(weekdayWrite);
+  uint8_t retval = (readByte(MCP7940_RTCWKDAY) & B11111000) | dow;  // Mask DOW bits & add DOW
+  if (dow > 0 && dow < 8)  // If parameter is in range, then
+  {
+    I2C_write(MCP7940_RTCWKDAY, retval);  // Write the register
+    retval = dow;                         // set the return value
+  }                                       // of if-then we have a good DOW
+  return retval;
+}  // of method weekdayWrite()
+template <class Transport>
+int8_t MCP7940_Base<Transport>::calibrate() const {
+  /*!
+      @brief   Calibrate the MCP7940 (overloaded)
+      @details When called with no parameters the internal calibration is reset to 0
+      @return  Always returns 0
+  */
+  MCP7940_INSTRUMENT(calibrate);
+  clearRegisterBit(MCP7940_CONTROL, MCP7940_CRSTRIM);  // fine trim mode on, to be safe
+  I2C_write(MCP7940_OSCTRIM, (uint8_t)0);              // Write zeros to the trim register
+  return (0);
+}  // of method calibrate()
+template <class Transport>
+int8_t MCP7940_Base<Transport>::calibrate(const int8_t newTrim) {
+  /*!
+      @brief   Calibrate the MCP7940 (overloaded)
+      @details When called with one int8 parameter that value is used as the new trim value
+      @param[in] newTrim New signed integer value to use for the trim register
+      @return  Returns the input "newTrim" value
+  */
+  MCP7940_INSTRUMENT(calibrate);
+  int8_t trim = abs(newTrim);  // Make a local copy of absolute value
+  if (newTrim < 0)             // if the trim is less than 0
+  {
+    trim = 0x80 | trim;                                // set non-excess 128 negative val
+  }                                                    // of if-then value of trim is less than 0
+  clearRegisterBit(MCP7940_CONTROL, MCP7940_CRSTRIM);  // fine trim mode on, to be safe    //
+  I2C_write(MCP7940_OSCTRIM, trim);                    // Write value to the trim register //
+  DateTime dt;
+  if (readNow(dt)) _SetUnixTime = dt.unixtime();  // Store time of last change
+  return newTrim;
+}  // of method calibrate()
+template <class Transport>
+int8_t MCP7940_Base<Transport>::calibrate(const DateTime& dt) {
+  /*!
+     @brief   Calibrate the MCP7940 (overloaded)
+     @details When called with a DateTime class value then an internal calibration is performed.
+     Accepts a current date/time value and compares that to the current date/time of the RTC and
+     computes a calibration factor depending upon the time difference between the two and how long
+     the timespan between the two is. The longer the period between setting the clock and comparing
+     the difference between real time and indicated time the better the resulting calibration
+     accuracy will be. The datasheet explains the calibration formula on page 28. First, the error
+     in parts-per-million is computed using PPM = (SecDev/ExpectedSeconds) * 10000000. Then the trim
+     register is computed using the formula TRIMVAL = (PPM*32768*60)/(1000000*2). The code below is
+     designed for easy reading, not for performance. The ppm <> 130 is computed by solving the
+     equation for the maximum TRIM value of 127 and computing the corresponding max and min values
+     for ppm. This allows the trim variable to be one byte rather than a long integer.
+     @param[in] dt Actual Date/time
+     @return  Returns the new calculated trim value
+  */
+  MCP7940_INSTRUMENT(calibrate);
+  int32_t ppm = getPPMDeviation(dt);
+  adjust(dt);  // set the new Date-Time value
+  ppm          = constrain(ppm, -130, 130);
+  int16_t trim = readCached(MCP7940_OSCTRIM);  // Read current trim register value
+  if (trim >> 7)                             // use negative value if necessary
+  {
+    trim = (~0x80 & trim) * -1;
+  }                                    // of if-then trim is set
+  trim += ppm * 32768 * 60 / 2000000;  // compute the new trim value
+  trim = constrain(trim, -127, 127);   // Clamp to value range
+  return calibrate((const int8_t)trim);
+}  // of method calibrate()
+template <class Transport>
+int8_t MCP7940_Base<Transport>::calibrate(const float fMeas) {
+  /*!
+      @brief   Calibrate the MCP7940 (overloaded)
+      @details When called with one floating point value then that is used as the measured
+               frequency. The overload calibrate(counts, gateMicros) gives the same trim, within
+               rounding, with integer arithmetic only
+      @param[in] fMeas Measured frequency in Herz
+      @return  Returns the new trim value
+  */
+  MCP7940_INSTRUMENT(calibrate);
+  return calibrate(calibrationTrim(getCalibrationTrim(), getSQWSpeed(), fMeas));
+}  // of method calibrate()
+template <class Transport>
+int8_t MCP7940_Base<Transport>::calibrate(const uint32_t counts, const uint32_t gateMicros) {
+  /*!
+      @brief   Calibrate the MCP7940 (overloaded)
+      @details The measured frequency is given as the number of MFP square wave cycles counted in
+               a gate time, e.g. 327680 cycles in 10000000us for the 32.768kHz output or 1 cycle in
+               the measured period of the 1Hz output. A frequency in millihertz is passed as the
+               counts with a gate time of 1000000000us. Only integer arithmetic is used and the
+               result is the same as that of calibrate(counts * 1000000.0 / gateMicros)
+      @param[in] counts     Number of square wave cycles counted
+      @param[in] gateMicros Gate time in microseconds
+      @return  Returns the new trim value
+  */
+  MCP7940_INSTRUMENT(calibrate);
+  return calibrate(calibrationTrim(getCalibrationTrim(), getSQWSpeed(), counts, gateMicros));
+}  // of method calibrate()
+template <class Transport>
+int8_t MCP7940_Base<Transport>::calibrateOrAdjust(const DateTime& dt) {
+  /*!
+    @brief   Calibrate the MCP7940 if the ppm deviation is < 130 and > -130 else Adjust the
+    datetime.
+    @details If the time had changed significantly (like happens during daylight savings time) then
+    just adjust the time to be the new time and leave the trim value alone.  One hour deviation in 6
+    months is 225 ppm.  If the ppm deviation is within -130 to 130 then assume we are just
+    calibrating the clock.
+    @param[in] dt Actual Date/time
+    @return  Returns the trim value
+   */
+  MCP7940_INSTRUMENT(calibrateOrAdjust);
+  int32_t ppm = getPPMDeviation(dt);
+  if ((ppm > 130) ||
+      (ppm < -130)) {  // calibration is out of range so just set the time  DML 2/5/2019
+    adjust(dt);
+    return readCached(MCP7940_OSCTRIM);
+  } else {
+    return calibrate(dt);
+  }  // if-then-else ppm out of range
+}  // method calibrateOrAdjust()
+template <class Transport>
+int32_t MCP7940_Base<Transport>::getPPMDeviation(const DateTime& dt) const {
+  /*!
+      @brief   Calculate the ppm deviation since the last time the clock was set
+      @details The internal _SetUniTime value is set when the clock is set. On this call the current
+     time is converted to unitime and compared with the stored value to determine the
+     part-per-million difference.  One hour deviation in 6 months is 225 ppm
+      @param[in] dt Actual Date/time
+      @return  difference in ppm
+  */
+  MCP7940_INSTRUMENT(getPPMDeviation);
+  DateTime rtcTime;
+  if (!readNow(rtcTime)) return 0;                              // No reading, no deviation
+  int32_t SecDeviation = dt.unixtime() - rtcTime.unixtime();  // Get difference in seconds
+  int32_t ExpectedSec  = dt.unixtime() - _SetUnixTime;      // Get number of seconds since set
+  if (ExpectedSec == 0) return 0;                           // Clock was set this second
+  int32_t ppm = 1000000 * SecDeviation / ExpectedSec;       // Multiply first to avoid truncation
+  return ppm;
+}
+template <class Transport>
+void MCP7940_Base<Transport>::setSetUnixTime(uint32_t aTime) {
+  /*!
+      @brief   Set the time the clock was last calibrated or adjusted.
+      @details Set the internal variable _SetUnixTime.  This is the time the clock was last
+     calibrated or adjusted.  This should only used to testing.
+      @param[in] aTime is the Unix time to set the time the clock was last calibrated or adjusted
+     to.
+      @return  void
+  */
+  _SetUnixTime = aTime;
+}
+template <class Transport>
+uint32_t MCP7940_Base<Transport>::getSetUnixTime() const {
+  /*!
+    @brief   Get the time the clock was last calibrated or adjusted.
+    @details Returns the internal variable _SetUnixTime.  This is the time the clock was last
+    calibrated or adjusted.  This should only used to testing.
+    @return  Returns the internal variable _SetUnixTime.
+  */
+  return _SetUnixTime;
+}
+template <class Transport>
+int8_t MCP7940_Base<Transport>::getCalibrationTrim() const {
+  /*!
+      @brief   Return the TRIMVAL trim value
+      @details Since the number in the register can be negative but is not in excess-128 format any
+     negative numbers need to be manipulated before returning
+      @return  Returns the current trim value, 0 on a bus error
+  */
+  MCP7940_INSTRUMENT(getCalibrationTrim);
+  uint8_t trim = readCached(MCP7940_OSCTRIM);  // read the register
+  if (trim >> 7) {                           // If trim is negative, the convert
+    trim = (0x7F & trim) * -1;               // convert to excess128 value
+  }                                          // of if-then less than zero trim
+  return ((int8_t)trim);
+}  // of method getCalibrationTrim()
+template <class Transport>
+bool MCP7940_Base<Transport>::getCalibrationTrim(int8_t& trim) const {
+  /*!
+      @brief      Return the TRIMVAL trim value and whether it could be read (overloaded)
+      @param[out] trim Current trim value, 0 on a bus error
+      @return     true if the register was read or came from the cache, otherwise false
+  */
+  const uint32_t errors = _errorCount;
+  trim                  = getCalibrationTrim();
+  return _errorCount == errors;
+}  // of method getCalibrationTrim()
+template <class Transport>
+bool MCP7940_Base<Transport>::setMFP(const bool value) const {
+  /*!
+      @brief   Sets the MFP (Multifunction Pin) to the requested state
+      @return  Returns true on success otherwise false
+  */
+  MCP7940_INSTRUMENT(setMFP);
+  if ((readCached(MCP7940_CONTROL) & 0x70) !=
+      0)  // Get Control register, error if SQWEN/ALM1EN/ALM0EN set
+  {
+    return false;
+  }  // of if-then an invalid value
+  writeRegisterBit(MCP7940_CONTROL, MCP7940_OUT, value);
+  return true;
+}  // of method setMFP()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::getMFP() const {
+  /*!
+      @brief   Gets the MFP (Multifunction Pin) value
+      @details On is true and Off is false. This is read from the control register if no alarms are
+     enabled, otherwise the two alarm states must be checked.
+      @return  Returns one of the following values;\n
+               0 = pin set LOW.\n
+               1 = pin set HIGH.\n
+               2 = pin controlled by alarms.\n
+               3 = pin controlled by square wave output.\n
+               On a bus error 0 is returned
+  */
+  MCP7940_INSTRUMENT(getMFP);
+  uint8_t controlRegister = readCached(MCP7940_CONTROL);  // Get control register contents
+  if (controlRegister & (1 << MCP7940_SQWEN))           // Square wave output enabled
+  {
+    return 3;  // MFP in SQW output mode
+  } else if ((controlRegister & (1 << MCP7940_ALM0EN)) |
+             (controlRegister &
+              (1 << MCP7940_ALM1EN))) {  // One or both alarms enabled, and no square wave output.
+    return 2;                            // MFP in alarm output mode
+  }                                      // of if-then-else square wave enabled
+  return bitRead(controlRegister, MCP7940_OUT);  // MFP in manual mode, return value
+}  // of method getMFP()
+template <class Transport>
+bool MCP7940_Base<Transport>::getMFP(uint8_t& mode) const {
+  /*!
+      @brief      Gets the MFP (Multifunction Pin) value and whether it could be read (overloaded)
+      @param[out] mode Value returned by getMFP(), 0 on a bus error
+      @return     true if the register was read or came from the cache, otherwise false
+  */
+  const uint32_t errors = _errorCount;
+  mode                  = getMFP();
+  return _errorCount == errors;
+}  // of method getMFP()
+template <class Transport>
+bool MCP7940_Base<Transport>::setAlarm(const uint8_t alarmNumber, const uint8_t alarmType,
+                                       const DateTime& dt, const bool state) const {
+  /*!
+      @brief   Sets one of the 2 alarms
+      @details In order to configure the alarm modules, the following steps need to be performed in
+     order:\n
+               1. Load the timekeeping registers and enable the oscillator\n
+               2. Configure the ALMxMSK<2:0> bits to select the desired alarm mask\n
+               3. Set or clear the ALMPOL bit according to the desired output polarity\n
+               4. Ensure the ALMxIF flag is cleared\n
+               5. Based on the selected alarm mask, load the alarm match value into the appropriate
+     register(s)\n
+               6. Enable the alarm module by setting the ALMxEN bit\n
+               There are two ALMPOL bits - one in the ALM0WKDAY register which can be written, one
+     in the ALM1WKDAY register which is read-only and reflects the value of the ALMPOL in ALM0WKDAY.
+      @param[in] alarmNumber Alarm 0 or Alarm 1
+      @param[in] alarmType   Alarm type from 0 to 7, see detailed description
+      @param[in] dt          DateTime alarm value used to set the alarm
+      @param[in] state       Alarm state to set to (0 for "off" and 1 for "on")
+               Only RTCSEC to RTCWKDAY (for the ST and OSCRUN bits) and ALMxWKDAY (for the
+               ALMPOL and ALMxIF bits) are read, CONTROL may come from the register cache. The
+               alarm registers are written in a single burst, the CONTROL register is only
+               written when the alarm enable bit changes and the deviceStart() poll is skipped when
+               the oscillator is already running.
+      @return  Returns true for success otherwise false
+  */
+  MCP7940_INSTRUMENT(setAlarm);
+  if (alarmNumber > 1 || alarmType > 7 || alarmType == 5 || alarmType == 6) {
+    return false;
+  }  // of if-then bad parameters
+  uint8_t clock[MCP7940_RTCWKDAY + 1];  // RTCSEC through RTCWKDAY
+  if (I2C_read(MCP7940_RTCSEC, clock) != sizeof(clock)) return false;  // Get ST and OSCRUN bits
+  if (!bitRead(clock[MCP7940_RTCSEC], MCP7940_ST) ||
+      !bitRead(clock[MCP7940_RTCWKDAY], MCP7940_OSCRUN)) {
+    if (!deviceStart()) return false;  // Start the oscillator, error if it doesn't run
+  }                                    // of if-then oscillator not running
+  return writeAlarm(alarmNumber, alarmType, dt, state);
+}  // of method setAlarm()
+template <class Transport>
+bool MCP7940_Base<Transport>::writeAlarm(const uint8_t alarmNumber, const uint8_t alarmType,
+                                         const DateTime& dt, const bool state) const {
+  /*!
+      @brief     Write the alarm registers once the oscillator is known to be running
+      @details   Used by setAlarm() and by the final step of MCP7940_Async::setAlarm(). Only the
+                 ALMxWKDAY register is read, CONTROL may come from the register cache, so the
+                 method never waits on the device
+      @param[in] alarmNumber Alarm 0 or Alarm 1
+      @param[in] alarmType   Alarm type from 0 to 7
+      @param[in] dt          DateTime alarm value used to set the alarm
+      @param[in] state       Alarm state to set to (0 for "off" and 1 for "on")
+      @return    Returns true for success otherwise false
+  */
+  if (alarmNumber > 1 || alarmType > 7 || alarmType == 5 || alarmType == 6) {
+    return false;
+  }  // of if-then bad parameters
+  const uint8_t offset  = 7 * alarmNumber;                         // Offset to be applied
+  const uint8_t enable  = alarmNumber ? MCP7940_ALM1EN : MCP7940_ALM0EN;  // CONTROL bit
+  const uint8_t wkday   = readByte(MCP7940_ALM0WKDAY + offset);  // ALMxIF is set by the device
+  uint8_t       control = readCached(MCP7940_CONTROL);
+  if (bitRead(control, enable)) {  // Turn off the alarm while it is being changed
+    bitClear(control, enable);
+    I2C_write(MCP7940_CONTROL, control);
+  }  // of if-then alarm enabled
+  uint8_t block[6];                                              // ALMxSEC through ALMxMTH
+  block[0] = int2bcd(dt.second());                               // Seconds
+  block[1] = int2bcd(dt.minute());                               // Minutes
+  block[2] = int2bcd(dt.hour());                                 // Also sets the 24Hour clock
+  block[3] = (wkday & ((1 << MCP7940_ALM0IF) | (1 << MCP7940_ALMPOL))) |  // Keep ALMPOL, ALMxIF
+             alarmType << 4 |                                    // Set 3 bits from alarmType
+             (dt.dayOfTheWeek() & 0x07);                         // Set 3 bits for dow from date
+  block[4] = int2bcd(dt.day());                                  // Day of month
+  block[5] = int2bcd(dt.month());                                // Month, R/O leap-year bit
+  if (I2C_write(MCP7940_ALM0SEC + offset, block) != sizeof(block)) return false;  // One burst
+  if (state) {
+    bitSet(control, enable);
+    I2C_write(MCP7940_CONTROL, control);  // Turn the alarm on
+  }                                       // of if-then alarm to be turned on
+  return true;
+}  // of method writeAlarm()
+template <class Transport>
+void MCP7940_Base<Transport>::setAlarmPolarity(const bool polarity) const {
+  /*!
+      @brief   Sets the alarm polarity
+      @details Alarm polarity (see also TABLE 5-10 on p.27 of the datasheet). Note: the MFP pin is
+     open collector, it needs an external pull-up resistor.\n If only one alarm is set:\n polarity =
+     0: MFP high when no alarm, low when alarm.\n polarity = 1: MFP low when no alarm, high when
+     alarm.\n\n If both alarms are set:\n polarity = 0: MFP high when no alarm or one alarm, low
+     when both alarms go off.\n polarity = 1: MFP low when no alarm, high when eihter or both alarms
+     go off.\n\n In most situations you will want to set polarity to 1 if you have two alarms set,
+     to be able to see when an alarm goes off using the MFP pin.
+      @param[in] polarity Boolean value to for polarity
+  */
+  MCP7940_INSTRUMENT(setAlarmPolarity);
+  writeRegisterBit(MCP7940_ALM0WKDAY, MCP7940_ALMPOL,
+                   polarity);  // Write polarity to the ALMPOL bit
+  return;
+}  // of method setAlarmPolarity()
+template <class Transport>
+DateTime MCP7940_Base<Transport>::getAlarm(const uint8_t alarmNumber, uint8_t& alarmType) const {
+  /*!
+      @brief   Gets the DateTime for the given alarm
+      @details update the alarmType parameter with the alarm type that was set. The 6 alarm
+               registers are read in a single burst
+      @param[in] alarmNumber Alarm number 0 or 1
+      @param[out] alarmType See detailed description for list of alarm types 0-7
+      @return DateTime value of alarm, with month 0 on a bus error
+  */
+  MCP7940_INSTRUMENT(getAlarm);
+  if (alarmNumber > 1)  // return an error if bad alarm number
+  {
+    return DateTime(0);
+  }  // of if-then bad alarm number
+  uint8_t block[6] = {0};
+  I2C_read(MCP7940_ALM0SEC + 7 * alarmNumber, block);  // Read ALMxSEC to ALMxMTH
+  return decodeAlarm(block, alarmType);
+}  // of method getAlarm()
+template <class Transport>
+bool MCP7940_Base<Transport>::getAlarm(const uint8_t alarmNumber, DateTime& dt,
+                                       uint8_t& alarmType) const {
+  /*!
+      @brief      Gets the DateTime and type of the given alarm and whether they could be read
+                  (overloaded)
+      @param[in]  alarmNumber Alarm number 0 or 1
+      @param[out] dt          DateTime value of alarm
+      @param[out] alarmType   Alarm type 0-7
+      @return     true if the registers were read, false on a bus error or a bad alarm number
+  */
+  const uint32_t errors = _errorCount;
+  dt                    = getAlarm(alarmNumber, alarmType);
+  return alarmNumber < 2 && _errorCount == errors;
+}  // of method getAlarm()
+template <class Transport>
+bool MCP7940_Base<Transport>::getAlarms(MCP7940_Alarm alarms[2]) const {
+  /*!
+      @brief   Gets the settings of both alarms
+      @details Reads ALM0SEC through ALM1MTH in a single 13 byte burst and decodes the date/time,
+               alarm type and ALMxIF interrupt flag of both alarms
+      @param[out] alarms Array of 2 alarm settings, index 0 for alarm 0 and 1 for alarm 1
+      @return  true if the registers were read successfully, otherwise false
+  */
+  MCP7940_INSTRUMENT(getAlarms);
+  uint8_t block[MCP7940_ALM1MTH - MCP7940_ALM0SEC + 1] = {0};
+  bool    success = I2C_read(MCP7940_ALM0SEC, block) == sizeof(block);
+  for (uint8_t i = 0; i < 2; ++i) {
+    const uint8_t* alarm  = block + 7 * i;
+    alarms[i].dateTime    = decodeAlarm(alarm, alarms[i].alarmType);
+    alarms[i].interrupt   = bitRead(alarm[3], MCP7940_ALM0IF);
+  }  // of for-next each alarm
+  return success;
+}  // of method getAlarms()
+template <class Transport>
+bool MCP7940_Base<Transport>::clearAlarm(const uint8_t alarmNumber) const {
+  /*!
+      @brief   Clears the given alarm
+      @param[in] alarmNumber Alarm number 0 or 1
+      @return False if the alarmNumber is out of range, otherwise true
+  */
+  MCP7940_INSTRUMENT(clearAlarm);
+  if (alarmNumber > 1) { return false; }  // of if-then a bad alarm number
+  clearRegisterBit(alarmNumber ? MCP7940_ALM1WKDAY : MCP7940_ALM0WKDAY,
+                   MCP7940_ALM0IF);  // reset register bit
+  return true;
+}  // of method clearAlarm()
+template <class Transport>
+bool MCP7940_Base<Transport>::setAlarmState(const uint8_t alarmNumber, const bool state) const {
+  /*!
+      @brief   Turns an alarm on or off without changing the alarm condition
+      @param[in] alarmNumber Alarm number 0 or 1
+      @param[in] state State to the set the alarm to
+      @return False if the alarmNumber is out of range, otherwise true
+  */
+  MCP7940_INSTRUMENT(setAlarmState);
+  if (alarmNumber > 1) { return false; }  // of if-then a bad alarm number
+  writeRegisterBit(MCP7940_CONTROL, alarmNumber ? MCP7940_ALM1EN : MCP7940_ALM0EN,
+                   state);  // Overwrite register bit
+  return true;
+}  // of setAlarmState()
+template <class Transport>
+bool MCP7940_Base<Transport>::getAlarmState(const uint8_t alarmNumber) const {
+  /*!
+      @brief   Return whether a given alarm is on or off
+      @param[in] alarmNumber Alarm number 0 or 1
+      @return False if the alarmNumber is out of range, off or on a bus error, otherwise true
+  */
+  MCP7940_INSTRUMENT(getAlarmState);
+  if (alarmNumber > 1) { return false; }  // of if-then a bad alarm number
+  return readRegisterBit(MCP7940_CONTROL,
+                         alarmNumber ? MCP7940_ALM1EN : MCP7940_ALM0EN);  // Get state of alarm
+}  // of getAlarmState()
+template <class Transport>
+bool MCP7940_Base<Transport>::isAlarm(const uint8_t alarmNumber) const {
+  /*!
+      @brief   Return whether a given alarm is active or not
+      @param[in] alarmNumber Alarm number 0 or 1
+      @return False if the alarmNumber is out of range, off or on a bus error, otherwise true
+  */
+  MCP7940_INSTRUMENT(isAlarm);
+  if (alarmNumber > 1) { return false; }  // of if-then a bad alarm number
+  return readRegisterBit(alarmNumber ? MCP7940_ALM1WKDAY : MCP7940_ALM0WKDAY,
+                         MCP7940_ALM0IF);  // Get alarm state
+}  // of method isAlarm()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::getSQWSpeed() const {
+  /*!
+      @brief  returns the list value for the frequency of the square wave
+      @return Integer value index for the square wave frequency:\n
+      0 = 1Hz\n
+      1 = 4.096KHz\n
+      2 = 8.192KHz\n
+      3 = 32.768KHz\n
+      4 = 64Hz\n
+      If square wave is not turned on or on a bus error then a 0 is returned
+  */
+  MCP7940_INSTRUMENT(getSQWSpeed);
+  uint8_t frequency = readCached(MCP7940_CONTROL);  // Read the control register
+  if (frequency & 0x40) {                         // return 2 bits if SQW enabled
+    if (frequency & (1 << MCP7940_CRSTRIM)) return 4;  // CRSTRIM overrides SQWFS with 64Hz
+    return (frequency & 0x03);
+  }  // of if-then square wave frequency set
+  else
+    return 0;
+}  // of method getSQWSpeed()
+template <class Transport>
+bool MCP7940_Base<Transport>::getSQWSpeed(uint8_t& frequency) const {
+  /*!
+      @brief      returns the square wave frequency index and whether it could be read (overloaded)
+      @param[out] frequency Value returned by getSQWSpeed(), 0 on a bus error
+      @return     true if the register was read or came from the cache, otherwise false
+  */
+  const uint32_t errors = _errorCount;
+  frequency             = getSQWSpeed();
+  return _errorCount == errors;
+}  // of method getSQWSpeed()
+template <class Transport>
+bool MCP7940_Base<Transport>::setSQWSpeed(uint8_t frequency, bool state) const {
+  /*!
+      @brief  set the square wave speed to a value
+      @param[in] frequency Integer value index for the square wave frequency:\n
+                          0 = 1Hz\n
+                          1 = 4.096KHz\n
+                          2 = 8.192KHz\n
+                          3 = 32.768KHz\n
+                          4 = 64Hz\n
+      @param[in] state Boolean value set to false if square wave is to be turned off, otherwise true
+      @return boolean state of the square wave
+  */
+  MCP7940_INSTRUMENT(setSQWSpeed);
+  if (frequency > 4) return state;                      // Ignore invalid frequency values
+  uint8_t registerValue = readCached(MCP7940_CONTROL);  // read the register to a variable
+  if (frequency < 4)                                    // If the frequency is < 64Hz
+  {
+    bitWrite(registerValue, MCP7940_SQWFS0, bitRead(frequency, 0));
+    bitWrite(registerValue, MCP7940_SQWFS1, bitRead(frequency, 1));
+    bitClear(registerValue, MCP7940_CRSTRIM);  // CRSTRIM bit must be cleared
+  } else                                       // If the frequency is 64Hz
+  {
+    bitSet(registerValue, MCP7940_CRSTRIM);  // CRSTRIM bit must be set for 64Hz
+  }                                          // of if-then-else less then 64Hz or equal
+  bitWrite(registerValue, MCP7940_SQWEN, state);
+  I2C_write(MCP7940_CONTROL, registerValue);  // Write register settings
+  return state;
+}  // of method setSQWState()
+template <class Transport>
+bool MCP7940_Base<Transport>::setSQWState(const bool state) const {
+  /*!
+      @brief  set the square wave generator on or off
+      @param[in] state Boolean value set to false if square wave is to be turned off, otherwise true
+      @return boolean state of the square wave
+  */
+  MCP7940_INSTRUMENT(setSQWState);
+  writeRegisterBit(MCP7940_CONTROL, MCP7940_SQWEN, state);  // set the one bit to state
+  return state;
+}  // of method setSQWState
+template <class Transport>
+bool MCP7940_Base<Transport>::getSQWState() const {
+  /*!
+      @brief  Get the square wave generator state
+      @return boolean state of the square wave, "true" for on and "false" for off or on a bus
+              error
+  */
+  MCP7940_INSTRUMENT(getSQWState);
+  return readRegisterBit(MCP7940_CONTROL, MCP7940_SQWEN);
+}  // of method getSQWState()
+template <class Transport>
+bool MCP7940_Base<Transport>::setBattery(const bool state) const {
+  /*!
+      @brief     Enable or disable the battery backup
+      @details   Has no effect on the MCP7940M, only on the MCP7940N
+      @param[in] state True for "on", False for "off"
+      @return    boolean state of the battery backup. "true" for on and "false" for off
+  */
+  MCP7940_INSTRUMENT(setBattery);
+  writeRegisterBit(MCP7940_RTCWKDAY, MCP7940_VBATEN, state);
+  return (state);
+}  // of method setBattery()
+template <class Transport>
+bool MCP7940_Base<Transport>::getBattery() const {
+  /*!
+      @brief     Return the battery backup state
+      @details   Has no effect on the MCP7940M, only on the MCP7940N
+      @return    boolean state of the battery backup mode. "true" for on and "false" for off or
+                 on a bus error
+  */
+  MCP7940_INSTRUMENT(getBattery);
+  return readRegisterBit(MCP7940_RTCWKDAY, MCP7940_VBATEN);
+}  // of method setBattery()
+template <class Transport>
+bool MCP7940_Base<Transport>::getPowerFail() const {
+  /*!
+      @brief     Return the power failure status
+      @return    boolean state of the power failure status. "true" if a power failure has occured,
+     otherwise "false", also on a bus error
+  */
+  MCP7940_INSTRUMENT(getPowerFail);
+  bool status = readRegisterBit(MCP7940_RTCWKDAY, MCP7940_PWRFAIL);
+  return status;
+}  // of method getPowerFail()
+template <class Transport>
+bool MCP7940_Base<Transport>::clearPowerFail() const {
+  /*!
+      @brief     Clears the power failure status flag
+      @details   Clearing PWRFAIL also resets the power-fail time-stamps
+      @return    Always returns true
+  */
+  MCP7940_INSTRUMENT(clearPowerFail);
+  I2C_write(MCP7940_RTCWKDAY, (uint8_t)(readByte(MCP7940_RTCWKDAY) & ~(1 << MCP7940_PWRFAIL)));
+  return true;
+}  // of method clearPowerFail()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::readRAMBlock(const uint8_t addr, void* data,
+                                              const uint8_t len) const {
+  /*!
+      @brief     Read a block of bytes from the SRAM
+      @details   The block is read in as few transactions as possible, each one filling the I2C
+                 receive buffer of BUFFER_LENGTH bytes, so the whole 64 byte SRAM is read in two
+                 transactions with the 32 byte AVR buffer. Addresses past the end of the SRAM wrap
+                 around to its start, just like the device's own address pointer
+      @param[in] addr SRAM address 0-63, higher values wrap around
+      @param[out] data Buffer for "len" bytes
+      @param[in] len Number of bytes to read, at most MCP7940_RAM_SIZE
+      @return    Number of bytes actually read, less than "len" on an I2C error
+  */
+  MCP7940_INSTRUMENT(readRAMBlock);
+  uint8_t*      bytePtr = (uint8_t*)data;                              // Pointer into the buffer
+  const uint8_t total   = len > MCP7940_RAM_SIZE ? MCP7940_RAM_SIZE : len;  // Bytes to read
+  uint8_t       done{0};                                               // Bytes read so far
+  while (done < total) {
+    const uint8_t chunk = total - done > BUFFER_LENGTH ? BUFFER_LENGTH : total - done;
+    const uint8_t received = busRead(MCP7940_ADDRESS,
+                                     MCP7940_RAM_ADDRESS + (addr + done) % MCP7940_RAM_SIZE,
+                                     bytePtr + done, chunk);  // Read the chunk
+    done += received;
+    if (received != chunk) break;  // Stop on a short read
+  }                                // of while bytes left to read
+  return done;
+}  // of method readRAMBlock()
+template <class Transport>
+uint8_t MCP7940_Base<Transport>::writeRAMBlock(const uint8_t addr, const void* data,
+                                               const uint8_t len) const {
+  /*!
+      @brief     Write a block of bytes to the SRAM
+      @details   The block is written in as few transactions as possible, each one filling the I2C
+                 transmit buffer with the address byte and BUFFER_LENGTH-1 data bytes, so the whole
+                 64 byte SRAM is written in three transactions with the 32 byte AVR buffer.
+                 Addresses past the end of the SRAM wrap around to its start, just like the device's
+                 own address pointer
+      @param[in] addr SRAM address 0-63, higher values wrap around
+      @param[in] data Buffer with "len" bytes
+      @param[in] len Number of bytes to write, at most MCP7940_RAM_SIZE
+      @return    Number of bytes actually written, less than "len" on an I2C error
+  */
+  MCP7940_INSTRUMENT(writeRAMBlock);
+  const uint8_t* bytePtr = (const uint8_t*)data;                        // Pointer into the buffer
+  const uint8_t  total   = len > MCP7940_RAM_SIZE ? MCP7940_RAM_SIZE : len;  // Bytes to write
+  uint8_t        done{0};                                               // Bytes written so far
+  while (done < total) {
+    const uint8_t chunk =
+        total - done > BUFFER_LENGTH - 1 ? BUFFER_LENGTH - 1 : total - done;  // Room for address
+    const uint8_t status = busWrite(MCP7940_ADDRESS,
+                                    MCP7940_RAM_ADDRESS + (addr + done) % MCP7940_RAM_SIZE,
+                                    bytePtr + done, chunk);  // Write the chunk
+    if (status != 0) break;                                              // Stop on error
+    done += chunk;
+  }  // of while bytes left to write
+  return done;
+}  // of method writeRAMBlock()
+/***************************************************************************************************
+** Implementation of MCP7940_EventLog                                                             **
+***************************************************************************************************/
+template <class Transport>
+MCP7940_EventLogBase<Transport>::MCP7940_EventLogBase(const MCP7940_Base<Transport>& rtc,
+                                                      const uint8_t payloadSize,
+                                                      const uint8_t start, const uint8_t length)
+    : _rtc(rtc),
+      _payloadSize(payloadSize),
+      _recordSize(payloadSize + 2),
+      _start(start % MCP7940_RAM_SIZE),
+      _slots(payloadSize == 0 || payloadSize + 2 > BUFFER_LENGTH - 1 ||
+                     length > MCP7940_RAM_SIZE - start % MCP7940_RAM_SIZE
+                 ? 0
+                 : length / (payloadSize + 2)) {
+  /*!
+      @brief     Class constructor
+      @details   The log has no records until begin() has been called. If the record doesn't fit
+                 into one I2C write or the area doesn't fit into the SRAM the capacity is 0
+      @param[in] rtc         MCP7940 instance
+      @param[in] payloadSize Bytes of payload per record, 1 to BUFFER_LENGTH-3
+      @param[in] start       First SRAM address used by the log, 0-63
+      @param[in] length      Number of SRAM bytes used by the log
+  */
+}  // of constructor MCP7940_EventLog()
+template <class Transport>
+uint8_t MCP7940_EventLogBase<Transport>::crc8(const uint8_t* data, const uint8_t len) {
+  /*!
+      @brief     CRC-8 with polynomial 0x07 and initial value 0xFF
+      @details   The non-zero initial value makes sure that an all-zero SRAM is not a valid record
+      @param[in] data Bytes to check
+      @param[in] len  Number of bytes
+      @return    CRC-8 value
+  */
+  uint8_t crc{0xFF};
+  for (uint8_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; ++b) crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+  }  // of for-next each byte
+  return crc;
+}  // of method crc8()
+template <class Transport>
+bool MCP7940_EventLogBase<Transport>::begin() {
+  /*!
+      @brief     Recover the log from the SRAM
+      @details   The whole log area is read with one readRAMBlock() call. The newest record is the
+                 valid record whose following slot doesn't hold the next sequence number, the
+                 number of records is then found by following the sequence numbers backwards
+      @return    True if the SRAM was read, otherwise false
+  */
+  uint8_t area[MCP7940_RAM_SIZE];
+  _count    = 0;
+  _sequence = 0;
+  if (_slots == 0) return false;
+  const uint8_t length = _slots * _recordSize;
+  if (_rtc.readRAMBlock(_start, area, length) != length) return false;
+  bool found{false};
+  for (uint8_t slot = 0; slot < _slots; ++slot) {
+    const uint8_t* record = area + slot * _recordSize;
+    if (crc8(record, _recordSize - 1) != record[_recordSize - 1]) continue;  // Not valid
+    const uint8_t* next = area + (slot + 1) % _slots * _recordSize;
+    if (crc8(next, _recordSize - 1) == next[_recordSize - 1] && next[0] == (uint8_t)(record[0] + 1))
+      continue;  // Not the end of a chain of records
+    if (!found || (int8_t)(record[0] - _sequence) > 0) {
+      _newest   = slot;
+      _sequence = record[0];
+      found     = true;
+    }  // of if-then newer end of chain
+  }    // of for-next each slot
+  if (!found) return true;  // Empty log
+  uint8_t slot = _newest;
+  do {
+    ++_count;
+    slot                   = (slot + _slots - 1) % _slots;
+    const uint8_t* record  = area + slot * _recordSize;
+    if (crc8(record, _recordSize - 1) != record[_recordSize - 1] ||
+        record[0] != (uint8_t)(_sequence - _count)) {
+      break;
+    }  // of if-then end of chain
+  } while (_count < _slots);
+  return true;
+}  // of method begin()
+template <class Transport>
+bool MCP7940_EventLogBase<Transport>::append(const void* payload) {
+  /*!
+      @brief     Append a record, overwriting the oldest one when the log is full
+      @param[in] payload Buffer holding the payload bytes
+      @return    True if the record was written, otherwise false
+  */
+  if (_slots == 0) return false;
+  uint8_t       record[BUFFER_LENGTH - 1];
+  const uint8_t slot = _count ? (_newest + 1) % _slots : 0;
+  record[0]          = _count ? _sequence + 1 : _sequence;
+  memcpy(record + 1, payload, _payloadSize);
+  record[_recordSize - 1] = crc8(record, _recordSize - 1);
+  if (_rtc.writeRAMBlock(_start + slot * _recordSize, record, _recordSize) != _recordSize) {
+    return false;
+  }  // of if-then write failed
+  _newest   = slot;
+  _sequence = record[0];
+  if (_count < _slots) ++_count;
+  return true;
+}  // of method append()
+template <class Transport>
+bool MCP7940_EventLogBase<Transport>::read(const uint8_t index, void* payload) const {
+  /*!
+      @brief     Read one record
+      @param[in] index Record number, 0 is the oldest and count()-1 the newest record
+      @param[out] payload Buffer receiving the payload bytes
+      @return    True if the record was read and is valid, otherwise false
+  */
+  if (index >= _count) return false;
+  uint8_t       record[BUFFER_LENGTH - 1];
+  const uint8_t slot = (_newest + _slots - (_count - 1 - index)) % _slots;
+  if (_rtc.readRAMBlock(_start + slot * _recordSize, record, _recordSize) != _recordSize ||
+      crc8(record, _recordSize - 1) != record[_recordSize - 1]) {
+    return false;
+  }  // of if-then read failed or record not valid
+  memcpy(payload, record + 1, _payloadSize);
+  return true;
+}  // of method read()
+template <class Transport>
+uint8_t MCP7940_EventLogBase<Transport>::readAll(void* payloads, const uint8_t maxRecords) const {
+  /*!
+      @brief     Read the payloads of all records with one readRAMBlock() call
+      @param[out] payloads   Buffer receiving the payloads one after the other, oldest first
+      @param[in]  maxRecords Number of payloads the buffer can hold
+      @return    Number of payloads copied, records which are no longer valid are skipped
+  */
+  if (_count == 0) return 0;
+  uint8_t       area[MCP7940_RAM_SIZE];
+  const uint8_t length = _slots * _recordSize;
+  if (_rtc.readRAMBlock(_start, area, length) != length) return 0;
+  uint8_t copied{0};
+  for (uint8_t index = 0; index < _count && copied < maxRecords; ++index) {
+    const uint8_t* record =
+        area + (_newest + _slots - (_count - 1 - index)) % _slots * _recordSize;
+    if (crc8(record, _recordSize - 1) != record[_recordSize - 1]) continue;
+    memcpy((uint8_t*)payloads + copied++ * _payloadSize, record + 1, _payloadSize);
+  }  // of for-next each record
+  return copied;
+}  // of method readAll()
+template <class Transport>
+bool MCP7940_EventLogBase<Transport>::clear() {
+  /*!
+      @brief     Erase all records
+      @return    True if the log area was cleared, otherwise false
+  */
+  uint8_t       area[MCP7940_RAM_SIZE] = {0};
+  const uint8_t length                 = _slots * _recordSize;
+  _count                               = 0;
+  _sequence                            = 0;
+  return _rtc.writeRAMBlock(_start, area, length) == length;
+}  // of method clear()
+/***************************************************************************************************
+** Implementation of MCP7940_Async                                                                **
+***************************************************************************************************/
+template <class Transport>
+typename MCP7940_AsyncBase<Transport>::Job* MCP7940_AsyncBase<Transport>::enqueue(
+    const uint8_t operation) {
+  /*!
+      @brief     Reserve the queue slot after the newest pending job
+      @details   The slot may still hold a finished job, whose status is then no longer available
+      @param[in] operation Operation type
+      @return    Queue slot, nullptr if all slots hold pending jobs
+  */
+  if (_pending == MCP7940_ASYNC_QUEUE) return nullptr;
+  Job& job       = _jobs[(_head + _pending++) % MCP7940_ASYNC_QUEUE];
+  job            = Job();
+  job.operation  = operation;
+  job.handle     = _nextHandle;
+  job.status     = MCP7940_ASYNC_PENDING;
+  job.started    = millis();
+  if (++_nextHandle == 0) _nextHandle = 1;  // 0 is never a valid handle
+  return &job;
+}  // of method enqueue()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::start() {
+  /*!
+      @brief     Queue a deviceStart()
+      @return    Handle of the operation, 0 if the queue is full
+  */
+  Job* job = enqueue(OP_START);
+  return job ? job->handle : 0;
+}  // of method start()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::stop() {
+  /*!
+      @brief     Queue a deviceStop()
+      @return    Handle of the operation, 0 if the queue is full
+  */
+  Job* job = enqueue(OP_STOP);
+  return job ? job->handle : 0;
+}  // of method stop()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::adjust(const DateTime& dt) {
+  /*!
+      @brief     Queue an adjust()
+      @details   As in the blocking adjust() the oscillator is stopped while the clock is set. The
+                 operation fails if the oscillator doesn't restart
+      @param[in] dt Date/time to set
+      @return    Handle of the operation, 0 if the queue is full
+  */
+  Job* job = enqueue(OP_ADJUST);
+  if (!job) return 0;
+  job->dateTime = dt;
+  return job->handle;
+}  // of method adjust()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::setAlarm(const uint8_t alarmNumber, const uint8_t alarmType,
+                                               const DateTime& dt, const bool state) {
+  /*!
+      @brief     Queue a setAlarm()
+      @details   If the oscillator isn't running it is started first, see MCP7940_Class::setAlarm()
+                 for the parameters
+      @param[in] alarmNumber Alarm number 0 or 1
+      @param[in] alarmType   Alarm type 0-7
+      @param[in] dt          Alarm date/time
+      @param[in] state       Alarm state to set
+      @return    Handle of the operation, 0 if the queue is full
+  */
+  Job* job = enqueue(OP_ALARM);
+  if (!job) return 0;
+  job->alarmNumber = alarmNumber;
+  job->alarmType   = alarmType;
+  job->state       = state;
+  job->dateTime    = dt;
+  return job->handle;
+}  // of method setAlarm()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::now() {
+  /*!
+      @brief     Queue a now(), the date/time read is returned by result()
+      @details   The device is always read in a single transaction, bypassing the cached clock of
+                 setNowCache() so that the step never waits for a resync
+      @return    Handle of the operation, 0 if the queue is full
+  */
+  Job* job = enqueue(OP_NOW);
+  return job ? job->handle : 0;
+}  // of method now()
+template <class Transport>
+bool MCP7940_AsyncBase<Transport>::poll() {
+  /*!
+      @brief     Perform the next step of the oldest pending operation
+      @details   Call this regularly from loop(). When an operation completes it is removed from the
+                 queue before the callback is called, so the callback may queue further operations
+      @return    True if operations are still pending
+  */
+  if (_pending == 0) return false;
+  Job&          job    = _jobs[_head];
+  const uint8_t result = run(job);
+  if (result != MCP7940_ASYNC_PENDING) {
+    job.status = result;
+    _head      = (_head + 1) % MCP7940_ASYNC_QUEUE;
+    --_pending;
+    if (_callback) _callback(job.handle, result);
+  }  // of if-then job finished
+  return _pending != 0;
+}  // of method poll()
+template <class Transport>
+void MCP7940_AsyncBase<Transport>::advance(Job& job, const uint8_t step) const {
+  /*!
+      @brief     Go to another step of a job and restart its timeout
+      @param[in] job  Job to update
+      @param[in] step Step to perform on the next poll()
+  */
+  job.step    = step;
+  job.started = millis();
+}  // of method advance()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::waitOscillator(Job& job, const bool running) {
+  /*!
+      @brief     One step of waiting for the OSCRUN bit, it is read at most once per millisecond
+      @param[in] job     Job which is waiting
+      @param[in] running OSCRUN value to wait for
+      @return    MCP7940_ASYNC_DONE when reached, MCP7940_ASYNC_FAILED on timeout, otherwise
+                 MCP7940_ASYNC_PENDING
+  */
+  const uint32_t ms = millis();
+  if (ms == _checked) return MCP7940_ASYNC_PENDING;  // Same pace as the blocking loop's delay(1)
+  _checked = ms;
+  if ((bool)_rtc.readRegisterBit(MCP7940_RTCWKDAY, MCP7940_OSCRUN) == running) {
+    return MCP7940_ASYNC_DONE;
+  }  // of if-then oscillator has changed
+  if (ms - job.started >= MCP7940_ASYNC_TIMEOUT) return MCP7940_ASYNC_FAILED;
+  return MCP7940_ASYNC_PENDING;
+}  // of method waitOscillator()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::run(Job& job) {
+  /*!
+      @brief     Perform the next step of a job
+      @param[in] job Job to run
+      @return    MCP7940_ASYNC_PENDING while steps remain, otherwise the final status
+  */
+  uint8_t wait;
+  switch (job.operation) {
+    case OP_START:
+      if (job.step == 0) {
+        _rtc.setRegisterBit(MCP7940_RTCSEC, MCP7940_ST);  // Set the ST bit
+        advance(job, 1);
+        return MCP7940_ASYNC_PENDING;
+      }                                    // of if-then first step
+      return waitOscillator(job, true);  // Wait for oscillator to start
+    case OP_STOP:
+      if (job.step == 0) {
+        _rtc.clearRegisterBit(MCP7940_RTCSEC, MCP7940_ST);  // Clear the ST bit
+        advance(job, 1);
+        return MCP7940_ASYNC_PENDING;
+      }                                     // of if-then first step
+      return waitOscillator(job, false);  // Wait for oscillator to stop
+    case OP_ADJUST:
+      switch (job.step) {
+        case 0:
+          _rtc.clearRegisterBit(MCP7940_RTCSEC, MCP7940_ST);  // Stop the oscillator
+          advance(job, 1);
+          return MCP7940_ASYNC_PENDING;
+        case 1:
+          wait = waitOscillator(job, false);  // Like adjust(), carry on if it doesn't stop
+          if (wait != MCP7940_ASYNC_PENDING) advance(job, 2);
+          return MCP7940_ASYNC_PENDING;
+        case 2: {
+          const DateTime& dt = job.dateTime;
+          uint8_t wkday = (_rtc.readByte(MCP7940_RTCWKDAY) & B11111000) | dt.dayOfTheWeek();
+          uint8_t block[7];
+          MCP7940_Codec::encodeTime(dt, wkday, block);  // Keeps VBATEN and PWRFAIL bits
+          if (_rtc.I2C_write(MCP7940_RTCSEC, block) != sizeof(block)) return MCP7940_ASYNC_FAILED;
+          advance(job, 3);
+          return MCP7940_ASYNC_PENDING;
+        }  // of case 2 write the time and restart
+        case 3:
+          wait = waitOscillator(job, true);  // Wait for the oscillator to restart
+          if (wait == MCP7940_ASYNC_DONE) advance(job, 4);
+          return wait == MCP7940_ASYNC_FAILED ? wait : MCP7940_ASYNC_PENDING;
+        default:
+          _rtc.weekdayWrite(job.dateTime.dayOfTheWeek());  // Silicon errata issue 4
+          _rtc.adjusted(job.dateTime);
+          return MCP7940_ASYNC_DONE;
+      }  // of switch adjust step
+    case OP_ALARM:
+      switch (job.step) {
+        case 0: {
+          uint8_t registers[MCP7940_RTCWKDAY + 1];
+          if (_rtc.I2C_read(MCP7940_RTCSEC, registers) != sizeof(registers)) {
+            return MCP7940_ASYNC_FAILED;
+          }  // of if-then read failed
+          if ((registers[MCP7940_RTCSEC] >> MCP7940_ST & 1) &&
+              (registers[MCP7940_RTCWKDAY] >> MCP7940_OSCRUN & 1)) {
+            advance(job, 2);  // Already running, write the alarm on the next poll
+            return MCP7940_ASYNC_PENDING;
+          }  // of if-then oscillator running
+          registers[MCP7940_RTCSEC] |= 1 << MCP7940_ST;
+          _rtc.I2C_write(MCP7940_RTCSEC, registers[MCP7940_RTCSEC]);  // Start the oscillator
+          advance(job, 1);
+          return MCP7940_ASYNC_PENDING;
+        }  // of case 0 check oscillator
+        case 1:
+          wait = waitOscillator(job, true);  // Wait for the oscillator to start
+          if (wait == MCP7940_ASYNC_DONE) advance(job, 2);
+          return wait == MCP7940_ASYNC_FAILED ? wait : MCP7940_ASYNC_PENDING;
+        default:  // Write the alarm registers directly, setAlarm() could wait on the oscillator
+          return _rtc.writeAlarm(job.alarmNumber, job.alarmType, job.dateTime, job.state)
+                     ? MCP7940_ASYNC_DONE
+                     : MCP7940_ASYNC_FAILED;
+      }  // of switch alarm step
+    default:  // A single read of the device, now() could wait for a resync
+      return _rtc.readNow(job.dateTime) ? MCP7940_ASYNC_DONE : MCP7940_ASYNC_FAILED;
+  }  // of switch operation
+}  // of method run()
+template <class Transport>
+const typename MCP7940_AsyncBase<Transport>::Job* MCP7940_AsyncBase<Transport>::find(
+    const uint8_t handle) const {
+  /*!
+      @brief     Find the queue slot of a handle
+      @param[in] handle Handle returned when the operation was queued
+      @return    Queue slot, nullptr if the handle is unknown or its slot has been reused
+  */
+  if (handle == 0) return nullptr;
+  for (uint8_t i = 0; i < MCP7940_ASYNC_QUEUE; ++i) {
+    if (_jobs[i].handle == handle) return &_jobs[i];
+  }  // of for-next each slot
+  return nullptr;
+}  // of method find()
+template <class Transport>
+uint8_t MCP7940_AsyncBase<Transport>::status(const uint8_t handle) const {
+  /*!
+      @brief     Return the status of a queued operation
+      @param[in] handle Handle returned when the operation was queued
+      @return    MCP7940_ASYNC_PENDING, MCP7940_ASYNC_DONE, MCP7940_ASYNC_FAILED or
+                 MCP7940_ASYNC_UNKNOWN if the slot has since been reused
+  */
+  const Job* job = find(handle);
+  return job ? job->status : MCP7940_ASYNC_UNKNOWN;
+}  // of method status()
+template <class Transport>
+bool MCP7940_AsyncBase<Transport>::result(const uint8_t handle, DateTime& dt) const {
+  /*!
+      @brief      Return the date/time read by a completed now() operation
+      @param[in]  handle Handle returned by now()
+      @param[out] dt     Date/time read
+      @return     True if the operation completed successfully, otherwise false
+  */
+  const Job* job = find(handle);
+  if (!job || job->operation != OP_NOW || job->status != MCP7940_ASYNC_DONE) return false;
+  dt = job->dateTime;
+  return true;
+}  // of method result()
+/***************************************************************************************************
+** Implementation of MCP7940_Scheduler                                                            **
+***************************************************************************************************/
+template <class Transport>
+MCP7940_SchedulerBase<Transport>::MCP7940_SchedulerBase(MCP7940_Base<Transport>& rtc) : _rtc(rtc) {
+  /*!
+      @brief     Class constructor
+      @param[in] rtc MCP7940 instance whose alarms are used
+  */
+  for (uint8_t i = 0; i < MCP7940_SCHEDULER_SIZE; ++i) _heap[i] = _position[i] = i;  // All free
+}  // of constructor MCP7940_Scheduler()
+template <class Transport>
+bool MCP7940_SchedulerBase<Transport>::begin() {
+  /*!
+      @brief     Turn off both hardware alarms and remove all virtual alarms
+      @details   ALMPOL is set, as with ALMPOL clear the MFP output only signals when both alarms
+                 have matched. The MFP is then low when idle and goes high on an alarm
+      @return    True if the oscillator is running, which is needed for the alarms to fire
+  */
+  _rtc.setAlarmPolarity(true);
+  for (uint8_t alarm = 0; alarm < 2; ++alarm) {
+    _rtc.setAlarmState(alarm, false);
+    _enabled[alarm]   = false;
+    _armedSlot[alarm] = NONE;
+  }  // of for-next each hardware alarm
+  _count = 0;
+  for (uint8_t i = 0; i < MCP7940_SCHEDULER_SIZE; ++i) _heap[i] = _position[i] = i;
+  return _rtc.deviceStatus();
+}  // of method begin()
+template <class Transport>
+uint8_t MCP7940_SchedulerBase<Transport>::add(const DateTime& first, const uint32_t periodSeconds,
+                                              const MCP7940_EventCallback callback) {
+  /*!
+      @brief     Add a virtual alarm
+      @details   Ids of cancelled or expired alarms are reused by later calls
+      @param[in] first         Date/time the alarm fires first
+      @param[in] periodSeconds Repeat interval in seconds, 0 for an alarm which fires once
+      @param[in] callback      Function called with the id when the alarm fires, may be nullptr
+      @return    Id of the alarm 1-MCP7940_SCHEDULER_SIZE, 0 if all alarms are in use
+  */
+  if (_count == MCP7940_SCHEDULER_SIZE) return 0;
+  const uint8_t slot      = _heap[_count];  // First free slot is kept right after the heap
+  _events[slot].next     = first.unixtime();
+  _events[slot].period   = periodSeconds;
+  _events[slot].callback = callback;
+  siftUp(_count++);
+  arm();
+  return slot + 1;
+}  // of method add()
+template <class Transport>
+bool MCP7940_SchedulerBase<Transport>::cancel(const uint8_t id) {
+  /*!
+      @brief     Remove a virtual alarm
+      @param[in] id Id returned by add()
+      @return    True if the alarm was scheduled, otherwise false
+  */
+  if (id == 0 || id > MCP7940_SCHEDULER_SIZE || _position[id - 1] >= _count) return false;
+  remove(_position[id - 1]);
+  arm();
+  return true;
+}  // of method cancel()
+template <class Transport>
+uint8_t MCP7940_SchedulerBase<Transport>::service() {
+  /*!
+      @brief     Fire all virtual alarms which are due and program the next ones
+      @details   To be called when the MFP signals an alarm or from loop(). Repeating alarms are
+                 moved to their first due time after the current time, so missed repetitions are
+                 fired only once. The callbacks are called after the heap has been updated and may
+                 add or cancel alarms, including their own
+      @return    Number of alarms fired
+  */
+  const uint32_t time = _rtc.now().unixtime();
+  uint8_t        fired{0};
+  while (_count && _events[_heap[0]].next <= time) {
+    const uint8_t slot  = _heap[0];
+    Event&        event = _events[slot];
+    if (event.period) {
+      event.next += ((time - event.next) / event.period + 1) * event.period;
+      siftDown(0);
+    } else {
+      remove(0);
+    }  // of if-then-else repeating alarm
+    if (event.callback) event.callback(slot + 1);
+    ++fired;
+  }  // of while alarms are due
+  arm();
+  return fired;
+}  // of method service()
+template <class Transport>
+bool MCP7940_SchedulerBase<Transport>::next(DateTime& dt) const {
+  /*!
+      @brief      Return the time of the earliest virtual alarm
+      @param[out] dt Date/time the next alarm fires
+      @return     False if no alarm is scheduled, otherwise true
+  */
+  if (!_count) return false;
+  dt = DateTime(_events[_heap[0]].next);
+  return true;
+}  // of method next()
+template <class Transport>
+bool MCP7940_SchedulerBase<Transport>::before(const uint8_t a, const uint8_t b) const {
+  /*!
+      @brief     Heap order, true if the event at heap index a fires before the one at index b
+      @param[in] a Heap index
+      @param[in] b Heap index
+      @return    True if a fires first
+  */
+  return _events[_heap[a]].next < _events[_heap[b]].next;
+}  // of method before()
+template <class Transport>
+void MCP7940_SchedulerBase<Transport>::swap(const uint8_t a, const uint8_t b) {
+  /*!
+      @brief     Swap two heap entries and update their positions
+      @param[in] a Heap index
+      @param[in] b Heap index
+  */
+  const uint8_t slot  = _heap[a];
+  _heap[a]            = _heap[b];
+  _heap[b]            = slot;
+  _position[_heap[a]] = a;
+  _position[_heap[b]] = b;
+}  // of method swap()
+template <class Transport>
+void MCP7940_SchedulerBase<Transport>::siftUp(uint8_t index) {
+  /*!
+      @brief     Move an entry towards the root until its parent fires no later
+      @param[in] index Heap index
+  */
+  while (index && before(index, (index - 1) / 2)) {
+    swap(index, (index - 1) / 2);
+    index = (index - 1) / 2;
+  }  // of while earlier than the parent
+}  // of method siftUp()
+template <class Transport>
+void MCP7940_SchedulerBase<Transport>::siftDown(uint8_t index) {
+  /*!
+      @brief     Move an entry away from the root until no child fires earlier
+      @param[in] index Heap index
+  */
+  for (;;) {
+    uint8_t child = 2 * index + 1;
+    if (child >= _count) break;
+    if (child + 1 < _count && before(child + 1, child)) ++child;  // Earlier of the two children
+    if (!before(child, index)) break;
+    swap(index, child);
+    index = child;
+  }  // of forever until the heap is in order
+}  // of method siftDown()
+template <class Transport>
+void MCP7940_SchedulerBase<Transport>::remove(const uint8_t index) {
+  /*!
+      @brief     Remove an entry, its slot becomes the first free slot after the heap
+      @param[in] index Heap index
+  */
+  swap(index, --_count);
+  if (index < _count) {
+    const uint8_t moved = _heap[index];
+    siftUp(index);
+    siftDown(_position[moved]);
+  }  // of if-then an entry was moved into the gap
+}  // of method remove()
+template <class Transport>
+void MCP7940_SchedulerBase<Transport>::arm() {
+  /*!
+      @brief     Program the two earliest virtual alarms into ALM0 and ALM1
+      @details   The earliest alarm is the heap's root and the second earliest is the earlier of the
+                 root's two children. A hardware alarm which already holds one of them at the right
+                 time is left alone, the other is reprogrammed and an unneeded one is turned off and
+                 its ALMxIF cleared
+  */
+  uint8_t wanted[2]{NONE, NONE};  // Slots which should be in the hardware alarms
+  if (_count) wanted[0] = _heap[0];
+  if (_count > 1) wanted[1] = _heap[_count > 2 && before(2, 1) ? 2 : 1];
+  bool done[2]{false, false};  // Wanted slot is already programmed
+  bool keep[2]{false, false};  // Hardware alarm holds a wanted slot
+  for (uint8_t w = 0; w < 2; ++w) {
+    for (uint8_t alarm = 0; alarm < 2 && wanted[w] != NONE; ++alarm) {
+      if (_enabled[alarm] && _armedSlot[alarm] == wanted[w] &&
+          _armedTime[alarm] == _events[wanted[w]].next) {
+        done[w] = keep[alarm] = true;
+      }  // of if-then already programmed
+    }    // of for-next each hardware alarm
+  }      // of for-next each wanted slot
+  for (uint8_t w = 0; w < 2; ++w) {
+    if (wanted[w] == NONE || done[w]) continue;
+    const uint8_t alarm = keep[0] ? 1 : 0;  // The first hardware alarm not kept
+    if (keep[alarm]) break;
+    keep[alarm] = program(alarm, wanted[w]);
+  }  // of for-next each wanted slot
+  for (uint8_t alarm = 0; alarm < 2; ++alarm) {
+    if (!keep[alarm] && _enabled[alarm]) {
+      _rtc.setAlarmState(alarm, false);
+      _rtc.clearAlarm(alarm);  // Release the MFP if this alarm has fired
+      _enabled[alarm]   = false;
+      _armedSlot[alarm] = NONE;
+    }  // of if-then alarm no longer needed
+  }    // of for-next each hardware alarm
+}  // of method arm()
+template <class Transport>
+bool MCP7940_SchedulerBase<Transport>::program(const uint8_t alarm, const uint8_t slot) {
+  /*!
+      @brief     Write one virtual alarm into a hardware alarm
+      @details   The alarm matches seconds, minutes, hour, day of the week, date and month. All six
+                 registers are written in one burst, which also clears ALMxIF and with it the MFP
+                 output, so an enabled alarm is reprogrammed with a single write. A match against
+                 a half-written alarm can at most cause an early call of service(), which fires
+                 nothing that isn't due
+      @param[in] alarm Hardware alarm 0 or 1
+      @param[in] slot  Event slot
+      @return    True if the alarm was written and is enabled, otherwise false
+  */
+  const DateTime dt(_events[slot].next);
+  uint8_t        block[6];                                         // ALMxSEC through ALMxMTH
+  block[0] = MCP7940_Codec::int2bcd(dt.second());                  // Seconds
+  block[1] = MCP7940_Codec::int2bcd(dt.minute());                  // Minutes
+  block[2] = MCP7940_Codec::int2bcd(dt.hour());                    // 24 hour clock
+  block[3] = 1 << MCP7940_ALMPOL | 7 << 4 | (dt.dayOfTheWeek() & 0x07);  // Full match, clear IF
+  block[4] = MCP7940_Codec::int2bcd(dt.day());                     // Day of month
+  block[5] = MCP7940_Codec::int2bcd(dt.month());                   // Month
+  if (_rtc.I2C_write(MCP7940_ALM0SEC + 7 * alarm, block) != sizeof(block)) {
+    _armedSlot[alarm] = NONE;
+    return false;
+  }  // of if-then write failed
+  if (!_enabled[alarm]) _enabled[alarm] = _rtc.setAlarmState(alarm, true);
+  _armedSlot[alarm] = slot;
+  _armedTime[alarm] = _events[slot].next;
+  return _enabled[alarm];
+}  // of method program()
+/***************************************************************************************************
+** Implementation of MCP7940_Calibrator                                                           **
+***************************************************************************************************/
+template <class Transport>
+MCP7940_CalibratorBase<Transport>::MCP7940_CalibratorBase(MCP7940_Base<Transport>& rtc,
+                                                          const uint8_t start, const uint8_t length)
+    : _rtc(rtc), _log(rtc, SAMPLE_SIZE, start, length) {
+  /*!
+      @brief     Class constructor
+      @details   The samples are only read from the SRAM by begin()
+      @param[in] rtc    MCP7940 instance to calibrate
+      @param[in] start  First SRAM address used for the samples, 0-63
+      @param[in] length Number of SRAM bytes used for the samples, 9 bytes per sample
+  */
+}  // of constructor MCP7940_Calibrator()
+template <class Transport>
+bool MCP7940_CalibratorBase<Transport>::begin() {
+  /*!
+      @brief     Find the samples kept in the SRAM and fit the drift through them
+      @return    True if the SRAM could be read, otherwise false
+  */
+  if (!_log.begin()) return false;
+  fit();
+  return true;
+}  // of method begin()
+template <class Transport>
+bool MCP7940_CalibratorBase<Transport>::clear() {
+  /*!
+      @brief     Remove all samples, e.g. after the crystal or the device has been changed
+      @return    True if the SRAM could be written, otherwise false
+  */
+  _ppm     = 0;
+  _error   = 0;
+  _inliers = 0;
+  return _log.clear();
+}  // of method clear()
+template <class Transport>
+bool MCP7940_CalibratorBase<Transport>::addSample(const DateTime& reference) {
+  /*!
+      @brief     Store a reference time, refit the drift and change the trim if the fit is confident
+      @details   The RTC is read directly, not from the cached time, so the sample should be taken
+                 as soon as possible after the reference time was obtained. The clock itself is not
+                 set, so the samples stay comparable
+      @param[in] reference Accurate current date/time, e.g. from GPS or NTP
+      @return    True if the sample was stored, false on an I2C error or if the RTC is more than
+                 32767 seconds from the reference time
+  */
+  DateTime rtcTime;
+  if (!_rtc.readNow(rtcTime)) return false;
+  const int32_t offset = (int32_t)(rtcTime.unixtime() - reference.unixtime());  // RTC ahead > 0
+  if (offset > 32767 || offset < -32767) return false;
+  const int8_t   trim = _rtc.getCalibrationTrim();
+  const uint32_t time = reference.unixtime();
+  uint8_t        sample[SAMPLE_SIZE];
+  for (uint8_t i = 0; i < 4; ++i) sample[i] = time >> (8 * i);  // Reference time, LSB first
+  sample[4] = offset;                                             // Offset in seconds, LSB first
+  sample[5] = offset >> 8;
+  sample[6] = trim;                                               // Trim in effect
+  if (!_log.append(sample)) return false;
+  fit();
+  if (confident()) {
+    // A trim step of 1 changes the rate by 2 clock cycles per minute, i.e. 1/0.98304 ppm
+    const float   steps   = -_ppm * 0.98304;
+    const int16_t newTrim =
+        constrain(trim + (int16_t)(steps + (steps < 0 ? -0.5 : 0.5)), -127, 127);
+    if (newTrim != trim) {
+      _rtc.calibrate((int8_t)newTrim);
+      fit();  // The stored samples now describe the new trim
+    }  // of if-then trim changes
+  }    // of if-then estimate is good enough
+  return true;
+}  // of method addSample()
+template <class Transport>
+bool MCP7940_CalibratorBase<Transport>::agrees(const int32_t seconds, const int32_t offset) {
+  /*!
+      @brief     Return whether two samples can belong to the same clock setting
+      @param[in] seconds Time between the samples
+      @param[in] offset  Difference of the offsets in milliseconds
+      @return    True if a drift of 250ppm plus MCP7940_CALIBRATION_OUTLIER explains the difference
+  */
+  return labs(offset) <= labs(seconds) / 4 + MCP7940_CALIBRATION_OUTLIER;
+}  // of method agrees()
+template <class Transport>
+void MCP7940_CalibratorBase<Transport>::fit() {
+  /*!
+      @brief     Fit the drift through the stored samples
+      @details   The offsets are kept in milliseconds after the trim correction and the sums of the
+                 fit in 64 bit integers, so that only the final divisions are done in floating
+                 point.
+                 Samples more than 2^25 seconds (388 days) older than the newest one are ignored so
+                 that the sums cannot overflow
+  */
+  int32_t       x[MAX_SAMPLES];     // Seconds relative to the newest sample
+  int32_t       y[MAX_SAMPLES];     // Offset in milliseconds, corrected to the current trim
+  int8_t        trim[MAX_SAMPLES];  // Trim in effect up to each sample
+  bool          use[MAX_SAMPLES];   // Sample is used by the fit
+  uint8_t       samples[MAX_SAMPLES][SAMPLE_SIZE];
+  const uint8_t n       = _log.readAll(samples, MAX_SAMPLES);
+  const int8_t  trimNow = _rtc.getCalibrationTrim();
+  for (uint8_t i = 0; i < n; ++i) {
+    const uint8_t* sample = samples[i];
+    x[i]    = (int32_t)((uint32_t)sample[0] | (uint32_t)sample[1] << 8 |
+                        (uint32_t)sample[2] << 16 | (uint32_t)sample[3] << 24);
+    y[i]    = (int16_t)(sample[4] | sample[5] << 8) * 1000L;
+    trim[i] = (int8_t)sample[6];
+  }  // of for-next each stored sample
+  _inliers = 0;
+  _ppm     = 0;
+  _error   = 0;
+  if (n < 2) return;
+  // A higher trim value slows the clock by 1/983040 s/s per step. The offset of each sample is
+  // changed to what it would have been had the current trim been in effect since the first sample
+  int64_t correction{0};  // In 1/24576 ms
+  for (uint8_t i = 1; i < n; ++i) {
+    correction += (int64_t)(trim[i] - trimNow) * (int32_t)(x[i] - x[i - 1]) * 25;
+    y[i] += correction / 24576;
+  }  // of for-next each sample
+  for (uint8_t i = 0; i < n - 1; ++i) x[i] -= x[n - 1];
+  x[n - 1] = 0;
+  // Walk the samples in time order. A sample which is further from the last good one than a drift
+  // of 250ppm can explain is ignored, unless the next sample agrees with it, in which case the
+  // clock was set and all samples before it are dropped
+  uint8_t anchor{0};
+  for (uint8_t i = 0; i < n; ++i) {
+    use[i] = x[i] >= -0x2000000L;
+    if (use[i] && !use[anchor]) anchor = i;  // First sample recent enough
+  }  // of for-next each sample
+  for (uint8_t i = anchor + 1; i < n; ++i) {
+    if (agrees(x[i] - x[anchor], y[i] - y[anchor])) {
+      anchor = i;
+    } else if (i + 1 < n && agrees(x[i + 1] - x[i], y[i + 1] - y[i])) {
+      for (uint8_t j = 0; j < i; ++j) use[j] = false;  // Clock was set
+      anchor = i;
+    } else {
+      use[i] = false;  // Outlier
+    }  // of if-then-else sample fits
+  }    // of for-next each sample
+  for (;;) {  // Least squares fit, removing the worst outlier each time
+    int64_t sx{0}, sy{0}, sxx{0}, sxy{0};
+    uint8_t m{0};
+    for (uint8_t i = 0; i < n; ++i) {
+      if (!use[i]) continue;
+      sx += x[i];
+      sy += y[i];
+      sxx += (int64_t)x[i] * x[i];
+      sxy += (int64_t)x[i] * y[i];
+      ++m;
+    }  // of for-next each sample
+    const int64_t dxx = m * sxx - sx * sx;  // m^2 times the variance of x
+    if (m < 2 || dxx <= 0) return;        // No time span, no drift
+    const float slope = (float)(m * sxy - sx * sy) / (float)dxx;  // ms per second
+    float       sumSquares{0}, worst{0};
+    uint8_t     worstIndex{0};
+    for (uint8_t i = 0; i < n; ++i) {
+      if (!use[i]) continue;
+      const float residual = ((float)(m * y[i] - sy) - slope * (float)(m * x[i] - sx)) / m;
+      sumSquares += residual * residual;
+      if (fabs(residual) > worst) {
+        worst      = fabs(residual);
+        worstIndex = i;
+      }  // of if-then new worst residual
+    }    // of for-next each sample
+    if (worst > MCP7940_CALIBRATION_OUTLIER && m > MCP7940_CALIBRATION_MIN) {
+      use[worstIndex] = false;
+      continue;
+    }  // of if-then outlier removed
+    // Both times have a resolution of one second, the difference of two uniformly distributed
+    // rounding errors has a standard deviation of sqrt(2/12)s which is the least error assumed
+    float sigma = m > 2 ? sqrt(sumSquares / (m - 2)) : 0;
+    if (sigma < 408) sigma = 408;
+    _inliers = m;
+    _ppm     = -slope * 1000;                        // ms per second to ppm, positive when slow
+    _error   = sigma * sqrt((float)m / dxx) * 1000;  // Standard error of the slope in ppm
+    return;
+  }  // of forever until no more outliers
+}  // of method fit()
+/***************************************************************************************************
+** Implementation of MCP7940_PowerLog                                                             **
+***************************************************************************************************/
+template <class Transport>
+MCP7940_PowerLogBase<Transport>::MCP7940_PowerLogBase(const MCP7940_Base<Transport>& rtc,
+                                                      const uint8_t start, const uint8_t length)
+    : _rtc(rtc), _log(rtc, RECORD_SIZE, start, length) {
+  /*!
+      @brief     Class constructor
+      @details   The log is only read from the SRAM by begin()
+      @param[in] rtc    MCP7940 instance
+      @param[in] start  First SRAM address used by the log, 0-63
+      @param[in] length Number of SRAM bytes used by the log, 8 bytes per outage
+  */
+}  // of constructor MCP7940_PowerLog()
+template <class Transport>
+bool MCP7940_PowerLogBase<Transport>::begin() {
+  /*!
+      @brief     Find the outages kept in the SRAM and capture a new one, to be called at startup
+      @return    True if the log could be read, otherwise false
+  */
+  if (!_log.begin()) return false;
+  uint8_t       records[MAX_RECORDS][RECORD_SIZE];
+  const uint8_t n = _log.readAll(records, MAX_RECORDS);
+  _downtime       = 0;
+  for (uint8_t i = 0; i < n; ++i) _downtime += records[i][4] | records[i][5] << 8;
+  capture();
+  return true;
+}  // of method begin()
+template <class Transport>
+bool MCP7940_PowerLogBase<Transport>::capture() {
+  /*!
+      @brief     Append the outage held by the device to the log and clear PWRFAIL
+      @details   One burst read and, if PWRFAIL is set, one write to the SRAM and clearPowerFail(),
+                 which reads RTCWKDAY again so a weekday increment since the burst read is kept.
+                 Time-stamps without a valid month are not logged but PWRFAIL is still cleared.
+                 If the log is full the oldest outage is overwritten
+      @return    True if an outage was logged, otherwise false
+  */
+  MCP7940_Snapshot snapshot;
+  if (!_rtc.readSnapshot(snapshot) || !snapshot.getPowerFail()) return false;
+  const DateTime up    = inYear(snapshot.getPowerUp(), snapshot.now());
+  const DateTime down  = inYear(snapshot.getPowerDown(), up);
+  bool           added = false;
+  if (up.month() && down.month()) {
+    const uint32_t minute   = (down.unixtime() - SECS_1970_TO_2000) / 60;
+    uint32_t       duration = (up.unixtime() - down.unixtime()) / 60;
+    if (duration > 0xFFFF) duration = 0xFFFF;  // Saturate at 45 days
+    uint8_t record[RECORD_SIZE];
+    for (uint8_t i = 0; i < 4; ++i) record[i] = minute >> (8 * i);  // LSB first
+    record[4] = duration;
+    record[5] = duration >> 8;
+    if (_log.count() == _log.capacity()) {
+      uint8_t oldest[RECORD_SIZE];
+      if (_log.read(0, oldest)) _downtime -= oldest[4] | oldest[5] << 8;  // Will be overwritten
+    }  // of if-then log full
+    added = _log.append(record);
+    if (added) _downtime += duration;
+  }  // of if-then time-stamps valid
+  _rtc.clearPowerFail();
+  return added;
+}  // of method capture()
+template <class Transport>
+bool MCP7940_PowerLogBase<Transport>::read(const uint8_t index, DateTime& powerDown,
+                                           DateTime& powerUp) const {
+  /*!
+      @brief      Return one outage from the log
+      @param[in]  index     Outage number, 0 is the oldest and count()-1 the newest
+      @param[out] powerDown Date/time that the power went off
+      @param[out] powerUp   Date/time that the power went back on
+      @return     True if the record was read and is valid, otherwise false
+  */
+  uint8_t record[RECORD_SIZE];
+  if (!_log.read(index, record)) return false;
+  const uint32_t minute = (uint32_t)record[0] | (uint32_t)record[1] << 8 |
+                          (uint32_t)record[2] << 16 | (uint32_t)record[3] << 24;
+  powerDown = DateTime(SECS_1970_TO_2000 + minute * 60);
+  powerUp   = DateTime(powerDown.unixtime() + (uint32_t)(record[4] | record[5] << 8) * 60);
+  return true;
+}  // of method read()
+template <class Transport>
+bool MCP7940_PowerLogBase<Transport>::clear() {
+  /*!
+      @brief     Remove all outages from the log
+      @return    True if the SRAM could be written, otherwise false
+  */
+  _downtime = 0;
+  return _log.clear();
+}  // of method clear()
+template <class Transport>
+DateTime MCP7940_PowerLogBase<Transport>::inYear(const DateTime& stamp, const DateTime& latest) {
+  /*!
+      @brief     Add the year to a power-fail time-stamp
+      @param[in] stamp  Time-stamp as returned by getPowerDown() or getPowerUp()
+      @param[in] latest Time the time-stamp cannot be after
+      @return    The latest date/time not after "latest" which matches the time-stamp
+  */
+  uint16_t year = latest.year();
+  for (;;) {
+    const DateTime dt(year, stamp.month(), stamp.day(), stamp.hour(), stamp.minute());
+    if (year == 2000 || (dt.unixtime() <= latest.unixtime() &&
+                         (stamp.month() != 2 || stamp.day() != 29 || year % 4 == 0))) {
+      return dt;
+    }  // of if-then year found
+    --year;
+  }  // of forever until a matching year is found
+}  // of method inYear()
+/***************************************************************************************************
+** Implementation of MCP7940_Timebase                                                             **
+***************************************************************************************************/
+template <class Transport>
+bool MCP7940_TimebaseBase<Transport>::begin(const uint16_t timeoutMs) {
+  /*!
+      @brief     Start the 1Hz square wave and find the second belonging to the edge count
+      @details   The interrupt routine calling edge() has to be attached before. After the next
+                 edge the device is read once, that is the second which started at the edge
+      @param[in] timeoutMs Maximum time to wait for an edge in milliseconds
+      @return    True if an edge was seen and the time was read, otherwise false
+  */
+  _synced = false;
+  if (!_rtc.setSQWSpeed(0, true)) return false;
+  const uint32_t start = micros();
+  const uint32_t first = edgeCount();
+  while (edgeCount() == first) {
+    if (micros() - start >= timeoutMs * 1000UL) return false;  // No edge, no interrupt routine
+  }  // of while waiting for the next edge
+  const uint32_t edges = edgeCount();
+  DateTime       dt;
+  if (!_rtc.readNow(dt) || edgeCount() != edges) return false;  // Read failed or was too late
+  _baseSeconds = dt.unixtime();
+  _baseEdges   = edges;
+  _synced      = true;
+  return true;
+}  // of method begin()
+template <class Transport>
+void MCP7940_TimebaseBase<Transport>::edge() {
+  /*!
+      @brief     Latch micros() on a rising MFP edge, to be called from the interrupt routine
+  */
+  const uint32_t now = micros();
+  if (_edges) {
+    int32_t interval = (int32_t)(now - _edgeMicros);
+    if (interval < 500000L) return;  // Glitch, not a new second
+    uint8_t seconds{1};
+    while (interval > 1500000L && seconds < 255) {  // Edges missed while interrupts were off
+      interval -= 1000000L;
+      ++seconds;
+    }  // of while more than one second passed
+    _edges = _edges + seconds - 1;
+    if (seconds == 1 && interval > 950000L && interval < 1050000L) {  // Within 5%
+      _excess = _excess + interval - 1000000L;
+      if (++_measured == MCP7940_TIMEBASE_WINDOW) {  // Window complete
+        _windowExcess   = _excess;
+        _windowMeasured = _measured;
+        _excess         = 0;
+        _measured       = 0;
+      }  // of if-then window complete
+    }    // of if-then interval can be measured
+  }      // of if-then not the first edge
+  _edgeMicros = now;
+  _edges      = _edges + 1;
+}  // of method edge()
+template <class Transport>
+bool MCP7940_TimebaseBase<Transport>::stamp(uint32_t& seconds, uint32_t& microseconds) const {
+  /*!
+      @brief      Return the current time
+      @param[out] seconds      UNIX time
+      @param[out] microseconds Fraction of the second, 0-999999
+      @return     False if begin() hasn't succeeded, otherwise true
+  */
+  return stamp(micros(), seconds, microseconds);
+}  // of method stamp()
+template <class Transport>
+bool MCP7940_TimebaseBase<Transport>::stamp(const uint32_t atMicros, uint32_t& seconds,
+                                            uint32_t& microseconds) const {
+  /*!
+      @brief      Return the time at which micros() had a given value
+      @details    The micros() value may be before the last edge, e.g. when it was latched by an
+                  interrupt routine and is processed later, as long as it is within 35 minutes
+      @param[in]  atMicros     micros() value, e.g. latched when an event occurred
+      @param[out] seconds      UNIX time
+      @param[out] microseconds Fraction of the second, 0-999999
+      @return     False if begin() hasn't succeeded, otherwise true
+  */
+  if (!_synced) return false;
+  noInterrupts();
+  const uint32_t edgeMicros = _edgeMicros;
+  const uint32_t edges      = _edges;
+  interrupts();
+  const int32_t drift  = getDrift();
+  const int32_t period = 1000000L + drift;  // MCU microseconds per RTC second
+  int32_t       elapsed = (int32_t)(atMicros - edgeMicros);
+  seconds               = _baseSeconds + (edges - _baseEdges);
+  while (elapsed < 0) {
+    elapsed += period;
+    --seconds;
+  }  // of while before the last edge
+  while (elapsed >= period) {
+    elapsed -= period;
+    ++seconds;
+  }  // of while edges not seen yet
+  microseconds = (int64_t)elapsed * 1000000L / period;  // Scale to RTC microseconds, 64 bit
+  if (microseconds > 999999) microseconds = 999999;
+  return true;
+}  // of method stamp()
+template <class Transport>
+int32_t MCP7940_TimebaseBase<Transport>::getDrift() const {
+  /*!
+      @brief     Return the drift of the MCU clock against the RTC
+      @details   Averaged over the current and the last complete window
+      @return    Drift in ppm, positive when micros() runs fast. 0 until two edges have been seen
+  */
+  noInterrupts();
+  const int32_t  excess   = _excess + _windowExcess;
+  const uint16_t measured = _measured + _windowMeasured;
+  interrupts();
+  return measured ? excess / (int32_t)measured : 0;
+}  // of method getDrift()
+template <class Transport>
+uint32_t MCP7940_TimebaseBase<Transport>::edgeCount() const {
+  /*!
+      @brief     Return the number of edges, read with interrupts off as it is 4 bytes long
+      @return    Edges counted by edge()
+  */
+  noInterrupts();
+  const uint32_t edges = _edges;
+  interrupts();
+  return edges;
+}  // of method edgeCount()
+  #ifdef MCP7940_INSTRUMENTATION
+template <class Transport>
+MCP7940_Base<Transport>::ApiScope::ApiScope(const MCP7940_Base<Transport>& rtc,
+                                            const MCP7940_Api api)
+    : _rtc(rtc), _outermost(rtc._currentApi == MCP7940_API_NONE), _start(0) {
+  /*!
+      @brief     Start measuring a public method, nested library calls are attributed to the caller
+      @param[in] rtc Instance being measured
+      @param[in] api Method being entered
+  */
+  if (_outermost) {
+    if (_rtc._apiStatistics == nullptr) {
+      _rtc._apiStatistics = new MCP7940_ApiStatistics[MCP7940_API_COUNT];
+    }  // of if-then first measured call
+    _rtc._currentApi = api;
+    ++_rtc._apiStatistics[api].calls;
+    _start = micros();
+  }  // of if-then outermost call
+}  // of constructor ApiScope()
+template <class Transport>
+MCP7940_Base<Transport>::ApiScope::~ApiScope() {
+  /*!
+      @brief     Stop measuring and add the elapsed time to the method's statistics
+  */
+  if (_outermost) {
+    _rtc._apiStatistics[_rtc._currentApi].micros += micros() - _start;
+    _rtc._currentApi = MCP7940_API_NONE;
+  }  // of if-then outermost call
+}  // of destructor ~ApiScope()
+template <class Transport>
+void MCP7940_Base<Transport>::recordTransaction(const uint8_t bytes, const bool failed) const {
+  /*!
+      @brief     Add one I2C transaction to the statistics of the method currently being measured
+      @param[in] bytes  Number of bytes moved, excluding the I2C address byte
+      @param[in] failed True if endTransmission() returned an error or a read came back short
+  */
+  if (_currentApi == MCP7940_API_NONE) return;  // Not called from an instrumented method
+  MCP7940_ApiStatistics& stats = _apiStatistics[_currentApi];
+  ++stats.transactions;
+  stats.bytes += bytes;
+  if (failed) ++stats.failures;
+}  // of method recordTransaction()
+template <class Transport>
+void MCP7940_Base<Transport>::dumpStatistics(Print& out) const {
+  /*!
+      @brief     Print one line per method that has been called since the last reset
+      @details   Each line shows the method name, calls, transactions, bytes, failures and the
+                 cumulative time in microseconds, separated by tabs
+      @param[in] out Destination, e.g. "Serial"
+  */
+  if (_apiStatistics == nullptr) return;  // Nothing has been measured yet
+  const char* name = MCP7940_API_NAMES;
+  for (uint8_t api = 0; api < MCP7940_API_COUNT; ++api) {
+    const MCP7940_ApiStatistics& stats = _apiStatistics[api];
+    if (stats.calls) {
+      for (const char* c = name; pgm_read_byte(c); ++c) out.print((char)pgm_read_byte(c));
+      out.print('\t');
+      out.print(stats.calls);
+      out.print('\t');
+      out.print(stats.transactions);
+      out.print('\t');
+      out.print(stats.bytes);
+      out.print('\t');
+      out.print(stats.failures);
+      out.print('\t');
+      out.println(stats.micros);
+    }  // of if-then method has been called
+    while (pgm_read_byte(name)) ++name;  // Skip to the next name
+    ++name;
+  }  // of for-next each method
+}  // of method dumpStatistics()
+template <class Transport>
+void MCP7940_Base<Transport>::resetStatistics() const {
+  /*!
+      @brief     Set all instrumentation counters back to zero
+  */
+  if (_apiStatistics == nullptr) return;  // Nothing has been measured yet
+  for (uint8_t api = 0; api < MCP7940_API_COUNT; ++api) {
+    _apiStatistics[api] = MCP7940_ApiStatistics();
+  }  // of for-next each method
+}  // of method resetStatistics()
+template <class Transport>
+const MCP7940_ApiStatistics& MCP7940_Base<Transport>::getStatistics(const MCP7940_Api api) const {
+  /*!
+      @brief     Return the counters of one method
+      @param[in] api Method, one of the MCP7940_API_xxx values
+      @return    Reference to the method's statistics
+  */
+  static const MCP7940_ApiStatistics none;  // Returned before anything has been measured
+  return _apiStatistics == nullptr ? none : _apiStatistics[api];
+}  // of method getStatistics()
+  #endif
+#endif